@@ -0,0 +1,114 @@
+/******************************************************************************
+
+   @file    alloctrack.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   replaced global operator new counting the allocations (SUDOKU_ALLOCS)
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+/*
+   Replacement of the global allocation functions, recording every allocation in SudokuAllocs
+   under the engine phase of the calling thread. The functions are not inline: include this
+   file in one translation unit of the program only (the one with the main function).
+*/
+
+#if defined(SUDOKU_ALLOCS)
+
+#include "sudoku.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace alloctrack
+{
+	inline void *allocate( std::size_t size )
+	{
+		SudokuAllocs::record(size);
+		if (void *p = std::malloc(size > 0 ? size : 1))
+			return p;
+		throw std::bad_alloc();
+	}
+
+	inline void *allocate( std::size_t size, std::align_val_t al )
+	{
+		SudokuAllocs::record(size);
+		auto align = static_cast<std::size_t>(al);
+		size = (size + align - 1) / align * align;
+	#if defined(_WIN32)
+		if (void *p = _aligned_malloc(size > 0 ? size : align, align))
+	#else
+		if (void *p = std::aligned_alloc(align, size > 0 ? size : align))
+	#endif
+			return p;
+		throw std::bad_alloc();
+	}
+
+	inline void release( void *p, std::align_val_t )
+	{
+	#if defined(_WIN32)
+		_aligned_free(p);
+	#else
+		std::free(p);
+	#endif
+	}
+}
+
+void *operator new  ( std::size_t size )                          { return alloctrack::allocate(size); }
+void *operator new[]( std::size_t size )                          { return alloctrack::allocate(size); }
+void *operator new  ( std::size_t size, std::align_val_t al )     { return alloctrack::allocate(size, al); }
+void *operator new[]( std::size_t size, std::align_val_t al )     { return alloctrack::allocate(size, al); }
+
+void *operator new  ( std::size_t size, const std::nothrow_t & ) noexcept
+{
+	try { return alloctrack::allocate(size); } catch (...) { return nullptr; }
+}
+
+void *operator new[]( std::size_t size, const std::nothrow_t & ) noexcept
+{
+	try { return alloctrack::allocate(size); } catch (...) { return nullptr; }
+}
+
+// the deallocation functions release with free() what the allocation functions got from malloc()
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void  operator delete  ( void *p ) noexcept                                         { std::free(p); }
+void  operator delete[]( void *p ) noexcept                                         { std::free(p); }
+void  operator delete  ( void *p, std::size_t ) noexcept                            { std::free(p); }
+void  operator delete[]( void *p, std::size_t ) noexcept                            { std::free(p); }
+void  operator delete  ( void *p, std::align_val_t al ) noexcept                    { alloctrack::release(p, al); }
+void  operator delete[]( void *p, std::align_val_t al ) noexcept                    { alloctrack::release(p, al); }
+void  operator delete  ( void *p, std::size_t, std::align_val_t al ) noexcept       { alloctrack::release(p, al); }
+void  operator delete[]( void *p, std::size_t, std::align_val_t al ) noexcept       { alloctrack::release(p, al); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // SUDOKU_ALLOCS
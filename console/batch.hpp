@@ -0,0 +1,649 @@
+/******************************************************************************
+
+   @file    batch.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   batch modes of the console application
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "gametimer.hpp"
+#include "boardcache.hpp"
+#include "boardreader.hpp"
+#include "boardarchive.hpp"
+#include "boardsink.hpp"
+#include "boardsort.hpp"
+#include "boardstats.hpp"
+#include "boardpipeline.hpp"
+#include "platform.hpp"
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <thread>
+#include <iomanip>
+#include <sstream>
+#if defined(_WIN32) && !defined(HEADLESS)
+#include <windows.h>
+#endif
+
+const TCHAR *title = _T("Sudoku");
+
+/*
+   Stop request of the endless batch modes: SIGINT (Ctrl+C), SIGTERM or the Escape key
+   (the latter only in the console build).
+*/
+
+class StopRequest
+{
+	static inline volatile std::sig_atomic_t flag_ = 0;
+
+	static void handler_( int )
+	{
+		flag_ = 1;
+	}
+
+public:
+
+	StopRequest()
+	{
+		flag_ = 0;
+		std::signal(SIGINT,  StopRequest::handler_);
+		std::signal(SIGTERM, StopRequest::handler_);
+	#if defined(_WIN32) && !defined(HEADLESS)
+		GetAsyncKeyState(VK_ESCAPE);
+	#endif
+	}
+
+	~StopRequest()
+	{
+		std::signal(SIGINT,  SIG_DFL);
+		std::signal(SIGTERM, SIG_DFL);
+	}
+
+	StopRequest( const StopRequest & ) = delete;
+	StopRequest &operator=( const StopRequest & ) = delete;
+
+	// the flag for SudokuBudget, so a long raise stops at once
+	const volatile std::sig_atomic_t *flag() const
+	{
+		return &flag_;
+	}
+
+	bool operator!() const
+	{
+	#if defined(_WIN32) && !defined(HEADLESS)
+		if (GetAsyncKeyState(VK_ESCAPE))
+			flag_ = 1;
+	#endif
+		return flag_ == 0;
+	}
+};
+
+/*
+   Command line: sudoku -<command>[<extension>] [options] [files]; the game mode (-g) is provided
+   by the caller, so the batch modes do not depend on the console user interface.
+*/
+
+template<typename F>
+int batch( int argc, TCHAR **argv, F &&game )
+{
+	size_t cnt = 0;
+	TCHAR  cmd = _T('g');
+	TCHAR  ext = 0;
+	auto   tmp = std::basic_string<TCHAR>(*argv) + _T(".board");
+	const TCHAR *file = tmp.c_str();
+
+	if (--argc > 0 && (++argv, **argv == _T('/') || **argv == _T('-')))
+	{
+		cmd = (TCHAR)std::tolower(*++*argv);
+		if (cmd != 0)
+			ext = (TCHAR)std::tolower(*++*argv);
+	}
+
+	auto files  = std::vector<const TCHAR *>();
+	auto cache  = std::unique_ptr<BoardCache>();
+	bool sync   = false;
+	bool merge  = false;
+	bool effort = false;
+	bool board_effort = false;
+	bool latency = false;
+	bool allocs  = false;
+	auto alloc_budget = uint64_t(0);
+	size_t over = 0;
+	const TCHAR *trace = nullptr;
+	auto memory = size_t(512) << 20;
+	auto top    = size_t(0);
+	auto jobs   = size_t(std::max(std::thread::hardware_concurrency(), 1U));
+	auto limit  = 0L;
+	auto nodes  = SIZE_MAX;
+
+	while (--argc > 0)
+	{
+		const TCHAR *arg = *++argv;
+		if (_tcscmp(arg, _T("-c")) == 0 && argc > 1)
+		{
+			--argc;
+			cache = std::make_unique<BoardCache>(*++argv);
+			if (!cache->is_open())
+			{
+				tcerr << ::title << ": cannot open the cache file" << std::endl;
+				return 1;
+			}
+			Sudoku::cache = cache.get();
+		}
+		else
+		if (_tcscmp(arg, _T("--stats")) == 0)
+			effort = true;
+		else
+		if (_tcscmp(arg, _T("--board-stats")) == 0)
+			effort = board_effort = true;
+		else
+		if (_tcscmp(arg, _T("--allocs")) == 0)
+			allocs = true;
+		else
+		if (_tcscmp(arg, _T("--alloc-budget")) == 0 && argc > 1)
+		{
+			--argc;
+			alloc_budget = static_cast<uint64_t>(_tcstoul(*++argv, nullptr, 10));
+		}
+		else
+		if (_tcscmp(arg, _T("--latency")) == 0)
+		{
+			latency = true;
+			SudokuLatency::enable();
+		}
+		else
+		if (_tcscmp(arg, _T("--trace")) == 0 && argc > 1)
+		{
+			--argc;
+			trace = *++argv;
+			SudokuTrace::enable();
+		}
+		else
+		if (_tcscmp(arg, _T("--sync")) == 0)
+			sync = true;
+		else
+		if (_tcscmp(arg, _T("--merge")) == 0)
+			merge = true;
+		else
+		if (_tcscmp(arg, _T("-j")) == 0 && argc > 1)
+		{
+			--argc;
+			jobs = std::max(static_cast<size_t>(_tcstoul(*++argv, nullptr, 10)), size_t(1));
+		}
+		else
+		if (_tcscmp(arg, _T("-k")) == 0 && argc > 1)
+		{
+			--argc;
+			top = static_cast<size_t>(_tcstoul(*++argv, nullptr, 10));
+		}
+		else
+		if (_tcscmp(arg, _T("--deadline")) == 0 && argc > 1)
+		{
+			--argc;
+			limit = _tcstol(*++argv, nullptr, 10);
+		}
+		else
+		if (_tcscmp(arg, _T("--nodes")) == 0 && argc > 1)
+		{
+			--argc;
+			nodes = static_cast<size_t>(_tcstoul(*++argv, nullptr, 10));
+		}
+		else
+		if (_tcscmp(arg, _T("--memory")) == 0 && argc > 1)
+		{
+			--argc;
+			memory = static_cast<size_t>(_tcstoul(*++argv, nullptr, 10)) << 20;
+		}
+		else
+			files.push_back(arg);
+	}
+
+	// search effort and allocations of the n-th board
+	auto board = [&]( const size_t n, const SudokuStats &stats, const SudokuAllocs &a )
+	{
+		if (board_effort)
+			std::cerr << '#' << n << ' ' << stats << std::endl;
+		if (alloc_budget > 0 && a.allocations() > alloc_budget)
+		{
+			over++;
+			std::cerr << '#' << n << " over the allocation budget: " << a << std::endl;
+		}
+	};
+
+	switch (cmd)
+	{
+		case _T('g'): // game
+		{
+			game();
+			break;
+		}
+
+		case _T('f'): // find
+		{
+			auto sudoku = Sudoku(Difficulty::Medium);
+			auto timer  = GameTimer<int>();
+			auto data   = std::vector<uint32_t>();
+
+			if (files.size() > 0)
+				file = files.front();
+
+			bool piped  = BoardFile::is_stdio(file);
+			auto out    = BoardSink(stdout);
+			auto app    = BoardSink(file, sync);
+
+			tcerr << ::title << " find" << std::endl;
+
+			auto stop   = StopRequest();
+			while (!stop)
+			{
+				auto before = SudokuStats::local();
+				auto allocated = SudokuAllocs::local();
+				sudoku.generate();
+				if (ext == _T('r') || ext == _T('x'))
+					sudoku.raise(ext == _T('x'), true, SudokuBudget{ .stop = stop.flag() });
+				board(++cnt, SudokuStats::local() - before, SudokuAllocs::local() - allocated);
+				if (std::find(data.begin(), data.end(), sudoku.signature) == data.end() && sudoku.test(ext != _T('x')))
+				{
+					data.push_back(sudoku.signature);
+					out.write(sudoku);
+					if (!piped)
+						app.write(sudoku);
+				}
+				out.tick();
+				app.tick();
+			}
+
+			tcerr << ::title << " find: " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+			break;
+		}
+
+		case _T('t'): // test
+		{
+			auto timer  = GameTimer<int>();
+			auto data   = std::unordered_set<uint32_t>();
+			auto order  = ext == _T('w') ? SudokuRecord::by_weight : ext == _T('l') ? SudokuRecord::by_length : SudokuRecord::by_rating;
+			auto coll   = BoardSort(order, memory);
+			auto out    = BoardSink(stdout);
+			auto progress = Progress();
+
+			tcerr << ::title << " test" << std::endl;
+
+			if (merge)
+			{
+				if (!BoardSort::merge(files, order, [&]( const SudokuRecord &r ){ progress(++cnt); if ((top == 0 || data.size() < top) && data.insert(r.signature).second) out.write(r); }))
+					tcerr << ::title << " test: cannot open the board file" << std::endl;
+				tcerr << ::title << " test: " << cnt << " boards merged, " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+				break;
+			}
+
+			auto reader = BoardReader(files.size() > 0 ? files : std::vector{file}, jobs);
+			auto pipe   = BoardPipeline(reader, jobs, []( Sudoku &s, BoardPipeline::Item &item )
+			{
+				auto bad = Sudoku::conflicts(item.rec);
+				if (bad.any())
+				{
+					auto msg = std::ostringstream();
+					msg << "ERROR: #" << item.pos + 1 << " conflicting cells:";
+					for (size_t p = 0; p < bad.size(); p++)
+						if (bad[p])
+							msg << " r" << p / 9 + 1 << 'c' << p % 9 + 1;
+					std::cerr << msg.str() << std::endl;
+				}
+				return s.test(false);
+			});
+			bool spill  = true;
+
+			if (top > 0)
+			{
+				auto best = BoardTop(order, top);
+
+				pipe.collect(true, [&]( const BoardPipeline::Item &item )
+				{
+					progress(++cnt);
+					board(item.pos + 1, item.stats, item.allocs);
+					if (item.valid)
+						best.push(item.rec);
+				});
+
+				best.select([&out]( const SudokuRecord &r ){ out.write(r); });
+
+				tcerr << ::title << " test: " << cnt << " boards read, " << best.size() << " boards selected, " << timer.now() << 's' << std::endl;
+				break;
+			}
+
+			pipe.collect(true, [&]( const BoardPipeline::Item &item )
+			{
+				progress(++cnt);
+				board(item.pos + 1, item.stats, item.allocs);
+				if (item.valid && data.insert(item.rec.signature).second)
+					spill = coll.push(item.rec) && spill;
+			});
+
+			if (!coll.merge([&out]( const SudokuRecord &r ){ out.write(r); }) || !spill)
+				tcerr << ::title << " test: temporary file error" << std::endl;
+
+			tcerr << ::title << " test: " << cnt << " boards read, " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+			break;
+		}
+
+		case _T('s'): // sort
+		{
+			auto timer  = GameTimer<int>();
+			auto data   = std::unordered_set<uint32_t>();
+			auto order  = ext == _T('w') ? SudokuRecord::by_weight : ext == _T('l') ? SudokuRecord::by_length : SudokuRecord::by_rating;
+			auto coll   = BoardSort(order, memory);
+			auto out    = BoardSink(stdout);
+			auto progress = Progress();
+
+			tcerr << ::title << " sort" << std::endl;
+
+			if (merge)
+			{
+				if (!BoardSort::merge(files, order, [&]( const SudokuRecord &r ){ progress(++cnt); if ((top == 0 || data.size() < top) && data.insert(r.signature).second) out.write(r); }))
+					tcerr << ::title << " sort: cannot open the board file" << std::endl;
+				tcerr << ::title << " sort: " << cnt << " boards merged, " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+				break;
+			}
+
+			auto reader = BoardReader(files.size() > 0 ? files : std::vector{file}, jobs);
+			auto pipe   = BoardPipeline(reader, jobs, []( Sudoku &s, BoardPipeline::Item & ){ return s.test(true); });
+			bool spill  = true;
+
+			if (top > 0)
+			{
+				auto best = BoardTop(order, top);
+
+				pipe.collect(true, [&]( const BoardPipeline::Item &item )
+				{
+					progress(++cnt);
+					board(item.pos + 1, item.stats, item.allocs);
+					if (item.valid)
+						best.push(item.rec);
+				});
+
+				best.select([&out]( const SudokuRecord &r ){ out.write(r); });
+
+				tcerr << ::title << " sort: " << cnt << " boards read, " << best.size() << " boards selected, " << timer.now() << 's' << std::endl;
+				break;
+			}
+
+			pipe.collect(true, [&]( const BoardPipeline::Item &item )
+			{
+				progress(++cnt);
+				board(item.pos + 1, item.stats, item.allocs);
+				if (item.valid && data.insert(item.rec.signature).second)
+					spill = coll.push(item.rec) && spill;
+			});
+
+			if (!coll.merge([&out]( const SudokuRecord &r ){ out.write(r); }) || !spill)
+				tcerr << ::title << " sort: temporary file error" << std::endl;
+
+			tcerr << ::title << " sort: " << cnt << " boards read, " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+			break;
+		}
+
+		case _T('r'): // raise
+		{
+			auto timer  = GameTimer<int>();
+			auto data   = std::unordered_set<uint32_t>();
+			auto late   = std::vector<size_t>();
+			auto reader = BoardReader(files.size() > 0 ? files : std::vector{file}, jobs);
+			auto out    = BoardSink(stdout, false, 1);
+			auto progress = Progress();
+
+			tcerr << ::title << " raise" << std::endl;
+
+			auto pipe   = BoardPipeline(reader, jobs, [&]( Sudoku &s, BoardPipeline::Item &item )
+			{
+				auto budget = SudokuBudget{};
+				if (limit > 0)
+					budget.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(limit);
+				budget.nodes = nodes;
+				item.expired = !s.raise(ext == _T('x'), jobs == 1, budget);
+				return s.test(ext != _T('x'));
+			});
+
+			pipe.collect(false, [&]( const BoardPipeline::Item &item )
+			{
+				progress(++cnt);
+				board(item.pos + 1, item.stats, item.allocs);
+				if (item.expired)
+					late.push_back(item.pos + 1);
+				if (item.valid && data.insert(item.rec.signature).second)
+					out.write(item.rec, item.pos + 1);
+			});
+
+			if (late.size() > 0)
+			{
+				std::sort(late.begin(), late.end());
+				tcerr << ::title << " raise: " << late.size() << " boards timed out:";
+				for (size_t n: late)
+					tcerr << ' ' << n;
+				tcerr << std::endl;
+			}
+
+			tcerr << ::title << " raise: " << cnt << " boards read, " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
+			break;
+		}
+
+		case _T('x'): // statistics
+		{
+			auto timer  = GameTimer<int>();
+			auto reader = BoardReader(files.size() > 0 ? files : std::vector{file}, jobs);
+			auto stats  = std::vector<BoardStats>(jobs);
+			auto workers = std::vector<std::thread>();
+
+			tcerr << ::title << " statistics" << std::endl;
+
+			for (size_t i = 0; i < stats.size(); i++)
+			{
+				workers.emplace_back([&reader, &stats, i]
+				{
+					auto sudoku   = Sudoku(Difficulty::Medium);
+					auto rec      = SudokuRecord();
+					auto progress = Progress();
+					while (reader.next(rec))
+					{
+						if (i == 0)
+							progress(reader.count());
+						sudoku.init(rec);
+						stats[i].add(rec, sudoku.record());
+					}
+				});
+			}
+
+			for (auto &worker: workers)
+				worker.join();
+			for (size_t i = 1; i < stats.size(); i++)
+				stats[0].merge(stats[i]);
+
+			if (ext == _T('j'))
+				stats[0].json(std::cout);
+			else
+				stats[0].report(std::cout);
+
+			tcerr << ::title << " statistics: " << stats[0].size() << " boards read, " << timer.now() << 's' << std::endl;
+			break;
+		}
+
+		case _T('a'): // archive
+		{
+			auto timer  = GameTimer<int>();
+			auto rec    = SudokuRecord();
+
+			if (files.size() == 0)
+			{
+				tcerr << ::title << " archive: missing archive file" << std::endl;
+				break;
+			}
+
+			if (ext == _T('x'))
+			{
+				auto archive = BoardArchive(files.front());
+				if (!archive.is_open())
+				{
+					tcerr << ::title << " extract: invalid archive file" << std::endl;
+					break;
+				}
+
+				auto out = BoardSink(stdout);
+
+				tcerr << ::title << " extract" << std::endl;
+
+				if (files.size() > 1)
+				{
+					auto level = static_cast<Difficulty>(_tcstol(files[1], nullptr, 10));
+					int  lo    = files.size() > 2 ? static_cast<int>(_tcstol(files[2], nullptr, 10)) : INT_MIN;
+					int  hi    = files.size() > 3 ? static_cast<int>(_tcstol(files[3], nullptr, 10)) : INT_MAX;
+					auto range = archive.find(level, lo, hi);
+					for (auto i = range.first; i < range.second; i++, cnt++)
+					{
+						auto r = archive.at(archive.entry(i));
+						out.write(r);
+					}
+				}
+				else
+				{
+					cnt = archive.parse([&out]( const SudokuRecord &r ){ out.write(r); return true; });
+				}
+
+				tcerr << ::title << " extract: " << cnt << " boards extracted, " << timer.now() << 's' << std::endl;
+			}
+			else
+			{
+				auto writer = BoardArchive::Writer(files.front());
+				auto reader = BoardReader(files.size() > 1 ? std::vector(files.begin() + 1, files.end()) : std::vector{file}, jobs);
+
+				tcerr << ::title << " archive" << std::endl;
+
+				while (reader.next(rec) && writer.write(rec))
+					cnt++;
+
+				if (!writer.close())
+					tcerr << ::title << " archive: write error" << std::endl;
+
+				tcerr << ::title << " archive: " << cnt << " boards stored, " << timer.now() << 's' << std::endl;
+			}
+
+			break;
+		}
+
+		case _T('?'): /* falls through */
+		case _T('h'): // help
+		{
+			std::cerr << "\n"
+			             "Sudoku game, solver and generator\n"
+			             "\n"
+			             "Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.\n"
+			             "This software is distributed under the MIT License.\n"
+			             "You are free to modify and redistribute it.\n"
+			             "\n"
+			             "Usage:\n"
+			             "sudoku -g        - game (default)\n"
+			             "sudoku -f [file] - find (append to file)\n"
+			             "       -fr       - force raise\n"
+			             "       -fx       - force raise and show extreme only\n"
+			             "sudoku -t [file] - test for extreme (read from file)\n"
+			             "       -tw       - sort by weight/length (default is rating/length)\n"
+			             "       -tl       - sort by length/rating (default is rating/length)\n"
+			             "sudoku -s [file] - sort (read from file)\n"
+			             "       -sw       - sort by weight/length (default is rating/length)\n"
+			             "       -sl       - sort by length/rating (default is rating/length)\n"
+			             "sudoku -r [file] - raise (read from file)\n"
+			             "       -rx       - show extreme only\n"
+			             "sudoku -x [file] - statistics of the boards (read from file)\n"
+			             "       -xj       - statistics in the JSON format\n"
+			             "sudoku -a arch [file]    - store boards in the binary archive (read from file)\n"
+			             "       -ax arch [l [lo [hi]]] - extract archive (level l, rating from lo to hi)\n"
+			             "       -c cache  - reuse ratings from the cache file (-f, -t, -s, -r)\n"
+			             "       --sync    - commit every batch of found boards to the disk (-f)\n"
+			             "       --stats   - show the total search effort (counters)\n"
+			             "       --board-stats - show the search effort of every board too\n"
+			             "       --allocs  - show the heap allocations of the engine phases (count/bytes)\n"
+			             "       --alloc-budget N - report the boards needing more than N allocations (-f, -t, -s, -r), exit code 2\n"
+			             "       --latency - show the latency percentiles of the engine calls, the file i/o and the game commands\n"
+			             "       --trace file - record the timeline in the Chrome trace format (chrome://tracing, Perfetto)\n"
+			             "       -j N      - number of worker threads (-t, -s, -r, -x)\n"
+			             "       --deadline S - time limit of raising a board in seconds (-r)\n"
+			             "       --nodes N - limit of layouts verified while raising a board (-r)\n"
+			             "       -k K      - show K best boards only (-t, -s)\n"
+			             "       --memory MB - memory limit for sorting, larger sets are sorted in temporary files (-t, -s)\n"
+			             "       --merge   - merge already sorted board files or archives (-t, -s)\n"
+			             "       -         - file name of the standard input (output for -f)\n"
+			             "sudoku -h        - this usage help\n"
+			             "sudoku -?        - this usage help\n"
+			          << std::endl;
+			break;
+		}
+
+		default:
+		{
+			tcerr << ::title << ": unknown command" << std::endl;
+			break;
+		}
+	}
+
+	if (effort)
+	{
+	#if defined(SUDOKU_STATS)
+		std::cerr << ::title << " stats: " << SudokuStats::total() << std::endl;
+	#else
+		std::cerr << ::title << " stats: not available (built without SUDOKU_STATS)" << std::endl;
+	#endif
+	}
+
+	if (allocs)
+	{
+	#if defined(SUDOKU_ALLOCS)
+		std::cerr << ::title << " allocations: " << SudokuAllocs::total() << std::endl;
+	#else
+		std::cerr << ::title << " allocations: not available (built without SUDOKU_ALLOCS)" << std::endl;
+	#endif
+	}
+
+	if (over > 0)
+		std::cerr << ::title << ": " << over << " boards over the allocation budget of " << alloc_budget << std::endl;
+
+	if (latency)
+		SudokuLatency::report(std::cerr);
+
+	if (trace != nullptr)
+	{
+		SudokuTrace::enable(false);
+		auto out = std::ofstream(std::filesystem::path(trace));
+		SudokuTrace::dump(out);
+		if (!out.good())
+			tcerr << ::title << ": cannot write the trace file" << std::endl;
+	}
+
+	return over > 0 ? 2 : 0;
+}
@@ -0,0 +1,419 @@
+/******************************************************************************
+
+   @file    bench.cpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   Sudoku engine benchmark
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#include "sudoku.hpp"
+#include "boardfile.hpp"
+#include "perfcounters.hpp"
+#include "alloctrack.hpp"
+#include "platform.hpp"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Cell = SudokuCell;
+
+/*
+   Fixed corpora: the extreme seeds and the boards generated from the given seed for every level
+   from easy to expert. Each operation is timed separately for every board (sample); the report
+   contains the median, p90 and p99 of the samples and the number of operations per second.
+   Where the hardware counters are available, their means per operation are reported as well.
+*/
+
+class SudokuBench
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Sample
+	{
+		double               ns;
+		PerfCounters::Values counts;
+		uint64_t             allocs;
+	};
+
+	struct Result
+	{
+		std::string          name;
+		size_t               ops;	// operations per sample
+		std::vector<double>  samples;	// nanoseconds
+		PerfCounters::Values counts{};	// sums of all samples
+		uint64_t             allocs{};
+
+		void add( const Sample &s )
+		{
+			samples.push_back(s.ns);
+			allocs += s.allocs;
+			for (size_t i = 0; i < counts.size(); i++)
+				counts[i] += s.counts[i];
+		}
+
+		// mean per operation
+		double count( const PerfCounters::Counter c ) const
+		{
+			return static_cast<double>(counts[c]) / static_cast<double>(samples.size() * ops);
+		}
+
+		double allocations() const
+		{
+			return static_cast<double>(allocs) / static_cast<double>(samples.size() * ops);
+		}
+
+		double ipc() const
+		{
+			return counts[PerfCounters::Cycles] > 0 ? static_cast<double>(counts[PerfCounters::Instructions]) / static_cast<double>(counts[PerfCounters::Cycles]) : 0;
+		}
+
+		double percentile( const double p ) const
+		{
+			auto n = static_cast<double>(samples.size());
+			auto i = static_cast<size_t>(std::ceil(p * n));
+			return samples[i > 0 ? i - 1 : 0];
+		}
+
+		double rate() const
+		{
+			return static_cast<double>(ops) * 1e9 / Result::percentile(0.5);
+		}
+	};
+
+	static constexpr const char *names_[] = { "easy", "medium", "hard", "expert", "extreme" };
+
+	uint32_t                                 seed_;
+	size_t                                   count_;
+	size_t                                   repeat_;
+	bool                                     all_;
+	std::vector<std::vector<SudokuRecord>>   corpus_;	// extreme seeds, then generated levels
+	std::vector<Result>                      results_;
+
+	static PerfCounters &perf_()
+	{
+		static PerfCounters perf;
+		return perf;
+	}
+
+	// the counters are running while the clock is read, not inside the measured operation only
+	template<typename F>
+	static Sample time_( F &&f )
+	{
+		auto &perf = SudokuBench::perf_();
+		auto allocs = SudokuAllocs::local().allocations();
+		perf.start();
+		auto start = Clock::now();
+		f();
+		auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		auto counts = perf.stop();
+		return { ns, counts, SudokuAllocs::local().allocations() - allocs };
+	}
+
+	// runs f(sudoku) for every board of the corpus sets from 'first', 'repeat_' times
+	template<typename F>
+	void run_( const std::string &name, const size_t first, F &&f )
+	{
+		auto sudoku = Sudoku(Difficulty::Medium);
+		auto result = Result{ name, 1, {} };
+
+		for (size_t r = 0; r < repeat_; r++)
+			for (size_t s = first; s < corpus_.size(); s++)
+				for (const SudokuRecord &rec: corpus_[s])
+				{
+					sudoku.level = rec.level;	// the extreme seeds are not rated again
+					sudoku.init(rec);
+					result.add(f(sudoku));
+				}
+
+		SudokuBench::add_(std::move(result));
+	}
+
+	void add_( Result result )
+	{
+		std::ranges::sort(result.samples);
+		std::cerr << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(1)
+		          << std::setw(12) << result.percentile(0.5) / 1e3
+		          << std::setw(12) << result.percentile(0.9) / 1e3
+		          << std::setw(12) << result.percentile(0.99) / 1e3
+		          << std::setw(14) << result.rate()
+		          << std::setw(12) << result.allocations() << std::endl;
+		results_.push_back(std::move(result));
+	}
+
+public:
+
+	SudokuBench( const uint32_t seed, const size_t count, const size_t repeat, const bool all ):
+		seed_{seed}, count_{count}, repeat_{repeat > 0 ? repeat : 1}, all_{all}, corpus_{}, results_{}
+	{
+		auto sudoku = Sudoku(Difficulty::Extreme);
+		auto &extreme = corpus_.emplace_back();
+		for (auto &tab: Sudoku::extreme)
+		{
+			sudoku.init(tab);
+			extreme.push_back(sudoku.record());
+		}
+
+		gen.seed(seed_);
+		for (int level = Difficulty::Easy; level < Difficulty::Extreme; level++)
+		{
+			auto &boards = corpus_.emplace_back();
+			while (boards.size() < count_)
+			{
+				sudoku.generate(static_cast<Difficulty>(level));
+				boards.push_back(sudoku.record());
+			}
+		}
+	}
+
+	void run()
+	{
+		std::cerr << std::left << std::setw(24) << "operation" << std::right << std::setw(12) << "median us"
+		          << std::setw(12) << "p90 us" << std::setw(12) << "p99 us" << std::setw(14) << "ops/s" << std::setw(12) << "allocs/op" << std::endl;
+
+		run_("solve", 0, []( Sudoku &s )
+		{
+			s.again();
+			return SudokuBench::time_([&s]{ std::ranges::max_element(s, Cell::by_length)->solve(); });
+		});
+
+		for (int level = Difficulty::Easy; level <= Difficulty::Extreme; level++)
+		{
+			auto sudoku = Sudoku();
+			auto result = Result{ std::string("generate/") + names_[level], 1, {} };
+			gen.seed(seed_);
+			for (size_t i = 0; i < count_ * repeat_; i++)
+				result.add(SudokuBench::time_([&sudoku, level]{ sudoku.generate(static_cast<Difficulty>(level)); }));
+			SudokuBench::add_(std::move(result));
+		}
+
+		run_("correct", 0, []( Sudoku &s )
+		{
+			return SudokuBench::time_([&s]{ s.correct(); });
+		});
+
+		// rating of the extreme seeds takes seconds per board
+		run_("parse_rating", all_ ? 0 : 1, []( Sudoku &s )
+		{
+			return SudokuBench::time_([&s]{ s.parse_rating(); });
+		});
+
+		run_("calculate_signature", 0, []( Sudoku &s )
+		{
+			return SudokuBench::time_([&s]{ auto a = Sudoku::Analysis(&s); s.calculate_signature(a); });
+		});
+
+		run_("raise", 2, [this]( Sudoku &s )
+		{
+			gen.seed(seed_);
+			return SudokuBench::time_([&s]{ s.raise(false, false, SudokuBudget{ SudokuBudget{}.deadline, 50 }); });
+		});
+
+		auto text = std::ostringstream();
+		size_t lines = 0;
+		for (auto &boards: corpus_)
+		{
+			for (auto &rec: boards)
+				text << rec << '\n';
+			lines += boards.size();
+		}
+		auto data = text.str();
+		auto result = Result{ "parse", lines, {} };
+		for (size_t i = 0; i < repeat_ * 10; i++)
+			result.add(SudokuBench::time_([&data]{ BoardFile::parse(data, []( const SudokuRecord & ){ return true; }); }));
+		SudokuBench::add_(std::move(result));
+
+		SudokuBench::counters();
+	}
+
+	void counters() const
+	{
+		auto &perf = SudokuBench::perf_();
+		if (!perf.any())
+		{
+			std::cerr << "\nhardware counters not available: " << perf.error() << std::endl;
+			return;
+		}
+
+		std::cerr << '\n' << std::left << std::setw(24) << "operation" << std::right;
+		for (size_t c = 0; c < PerfCounters::Count; c++)
+			std::cerr << std::setw(14) << PerfCounters::names[c];
+		std::cerr << std::setw(8) << "ipc" << std::endl;
+
+		for (auto &r: results_)
+		{
+			std::cerr << std::left << std::setw(24) << r.name << std::right << std::fixed << std::setprecision(1);
+			for (size_t c = 0; c < PerfCounters::Count; c++)
+				if (perf.available(static_cast<PerfCounters::Counter>(c)))
+					std::cerr << std::setw(14) << r.count(static_cast<PerfCounters::Counter>(c));
+				else
+					std::cerr << std::setw(14) << "-";
+			std::cerr << std::setw(8) << std::setprecision(2) << r.ipc() << std::endl;
+		}
+	}
+
+	void json( std::ostream &out ) const
+	{
+		auto &perf = SudokuBench::perf_();
+		out << std::fixed << std::setprecision(1)
+		    << "{\"seed\":" << seed_ << ",\"count\":" << count_ << ",\"repeat\":" << repeat_
+		    << ",\"counters\":" << (perf.any() ? "true" : "false") << ",\"results\":[";
+		for (size_t i = 0; i < results_.size(); i++)
+		{
+			auto &r = results_[i];
+			out << (i > 0 ? "," : "") << "\n{\"name\":\"" << r.name << "\",\"samples\":" << r.samples.size()
+			    << ",\"median_ns\":" << r.percentile(0.5) << ",\"p90_ns\":" << r.percentile(0.9)
+			    << ",\"p99_ns\":" << r.percentile(0.99) << ",\"ops_per_s\":" << r.rate();
+		#if defined(SUDOKU_ALLOCS)
+			out << ",\"allocs_per_op\":" << r.allocations();
+		#endif
+			for (size_t c = 0; c < PerfCounters::Count; c++)
+				if (perf.available(static_cast<PerfCounters::Counter>(c)))
+					out << ",\"" << PerfCounters::names[c] << "\":" << r.count(static_cast<PerfCounters::Counter>(c));
+			if (perf.available(PerfCounters::Cycles) && perf.available(PerfCounters::Instructions))
+				out << ",\"ipc\":" << std::setprecision(3) << r.ipc() << std::setprecision(1);
+			out << '}';
+		}
+		out << "\n]}" << std::endl;
+	}
+
+	// returns the number of operations slower than the baseline by more than 'tolerance' percent
+	// or allocating more than in the baseline
+	size_t compare( std::istream &baseline, const double tolerance ) const
+	{
+		auto text = std::string(std::istreambuf_iterator<char>(baseline), {});
+		size_t regressions = 0;
+
+		std::cerr << '\n' << std::left << std::setw(24) << "operation" << std::right << std::setw(12) << "baseline us"
+		          << std::setw(12) << "median us" << std::setw(10) << "change" << std::endl;
+
+		for (auto &r: results_)
+		{
+			auto pos = text.find("\"name\":\"" + r.name + "\"");
+			if (pos == text.npos || (pos = text.find("\"median_ns\":", pos)) == text.npos)
+				continue;
+
+			double base = std::strtod(text.c_str() + pos + 12, nullptr);
+			double now  = r.percentile(0.5);
+			double diff = base > 0 ? (now / base - 1) * 100 : 0;
+			bool   slow = diff > tolerance;
+
+			bool   more = false;
+		#if defined(SUDOKU_ALLOCS)
+			auto end = text.find('}', pos);
+			if ((pos = text.find("\"allocs_per_op\":", pos)) < end)
+				more = r.allocations() > std::strtod(text.c_str() + pos + 16, nullptr) + 0.05;
+		#endif
+			if (slow || more) regressions++;
+
+			std::cerr << std::left << std::setw(24) << r.name << std::right << std::fixed << std::setprecision(1)
+			          << std::setw(12) << base / 1e3 << std::setw(12) << now / 1e3
+			          << std::setw(9) << std::showpos << diff << std::noshowpos << '%'
+			          << (slow ? "  REGRESSION" : "") << (more ? "  MORE ALLOCATIONS" : "") << std::endl;
+		}
+
+		return regressions;
+	}
+};
+
+int _tmain( int argc, TCHAR **argv )
+{
+	uint32_t     seed      = 1;
+	size_t       count     = 10;
+	size_t       repeat    = 3;
+	bool         all       = false;
+	double       tolerance = 10;
+	const TCHAR *output    = nullptr;
+	const TCHAR *baseline  = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const TCHAR *arg = argv[i];
+		const TCHAR *val = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (_tcscmp(arg, _T("-a")) == 0)                   all       = true;
+		else
+		if (_tcscmp(arg, _T("-s")) == 0 && val != nullptr) seed      = static_cast<uint32_t>(_tcstoul(argv[++i], nullptr, 10));
+		else
+		if (_tcscmp(arg, _T("-n")) == 0 && val != nullptr) count     = static_cast<size_t>(_tcstoul(argv[++i], nullptr, 10));
+		else
+		if (_tcscmp(arg, _T("-r")) == 0 && val != nullptr) repeat    = static_cast<size_t>(_tcstoul(argv[++i], nullptr, 10));
+		else
+		if (_tcscmp(arg, _T("-t")) == 0 && val != nullptr) tolerance = static_cast<double>(_tcstol(argv[++i], nullptr, 10));
+		else
+		if (_tcscmp(arg, _T("-o")) == 0 && val != nullptr) output    = argv[++i];
+		else
+		if (_tcscmp(arg, _T("-c")) == 0 && val != nullptr) baseline  = argv[++i];
+		else
+		{
+			std::cerr << "\n"
+			             "Sudoku engine benchmark\n"
+			             "\n"
+			             "Usage:\n"
+			             "bench [options]\n"
+			             "       -s seed   - seed of the generated boards (default 1)\n"
+			             "       -n count  - number of generated boards per level (default 10)\n"
+			             "       -r repeat - number of runs over the corpus (default 3)\n"
+			             "       -a        - rate the extreme seeds too (slow)\n"
+			             "       -o file   - write the results in the JSON format to the file (default stdout)\n"
+			             "       -c file   - compare the results with the baseline JSON file\n"
+			             "       -t pct    - tolerance of the comparison in percent (default 10)\n"
+			          << std::endl;
+			return 1;
+		}
+	}
+
+	auto bench = SudokuBench(seed, count, repeat, all);
+	bench.run();
+
+	if (output != nullptr)
+	{
+		auto file = std::ofstream(std::filesystem::path(output));
+		bench.json(file);
+	}
+	else
+	{
+		bench.json(std::cout);
+	}
+
+	if (baseline != nullptr)
+	{
+		auto file = std::ifstream(std::filesystem::path(baseline));
+		if (!file)
+		{
+			tcerr << "bench: cannot open the baseline file " << baseline << std::endl;
+			return 1;
+		}
+		if (bench.compare(file, tolerance) > 0)
+			return 2;
+	}
+
+	return 0;
+}
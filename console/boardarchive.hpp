@@ -0,0 +1,298 @@
+/******************************************************************************
+
+   @file    boardarchive.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardArchive class: binary archive of the boards
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "mapfile.hpp"
+#include "platform.hpp"
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string_view>
+#include <climits>
+#include <cstring>
+#include <cstdint>
+
+/*
+   Archive layout (all numbers little endian):
+   header  - 64 bytes: magic, version, record size, number of records, offset of the index
+   records - 64 bytes each: cells packed at 4 bits (41 bytes), immutable mask (11 bytes),
+             level (1), length (1), rating (2), signature (4), duration (4)
+   index   -  8 bytes per record: record number (4), rating (2), level (1), reserved (1),
+             ordered by level, then by rating (descending), then by record number
+*/
+
+class BoardArchive
+{
+public:
+
+	static constexpr size_t HeaderSize = 64;
+	static constexpr size_t RecordSize = 64;
+	static constexpr size_t EntrySize  = 8;
+
+private:
+
+	static constexpr char     Magic[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'A', 'R' };
+	static constexpr uint32_t Version  = 1;
+
+	MappedFile     file_;
+	uint64_t       count_;
+	const uint8_t *records_;
+	const uint8_t *index_;
+
+	static uint64_t get_( const uint8_t *p, const size_t n )
+	{
+		uint64_t v = 0;
+		for (size_t i = n; i-- > 0; )
+			v = (v << 8) | p[i];
+		return v;
+	}
+
+	static void put_( uint8_t *p, const size_t n, uint64_t v )
+	{
+		for (size_t i = 0; i < n; i++, v >>= 8)
+			p[i] = static_cast<uint8_t>(v);
+	}
+
+	static void header_( uint8_t *p, const uint64_t count, const uint64_t index )
+	{
+		std::memset(p, 0, HeaderSize);
+		std::memcpy(p, Magic, sizeof(Magic));
+		put_(p +  8, 4, Version);
+		put_(p + 12, 4, RecordSize);
+		put_(p + 16, 8, count);
+		put_(p + 24, 8, index);
+	}
+
+	Difficulty level_( const uint64_t pos ) const { return static_cast<Difficulty>(index_[pos * EntrySize + 6]); }
+	int        rating_( const uint64_t pos ) const { return static_cast<int16_t>(get_(index_ + pos * EntrySize + 4, 2)); }
+
+public:
+
+	static void pack( const SudokuRecord &rec, uint8_t *p )
+	{
+		std::memset(p, 0, RecordSize);
+		for (size_t i = 0; i < rec.cells.size(); i++)
+		{
+			char c = rec.cells[i];
+			bool immutable = c >= '1' && c <= '9';
+			uint n = immutable ? static_cast<uint>(c - '0') : c >= 'A' && c <= 'I' ? static_cast<uint>(c - '@') : 0;
+			p[i / 2] = static_cast<uint8_t>(p[i / 2] | n << (i % 2 * 4));
+			if (immutable)
+				p[41 + i / 8] = static_cast<uint8_t>(p[41 + i / 8] | 1 << (i % 8));
+		}
+
+		p[52] = static_cast<uint8_t>(rec.level);
+		p[53] = static_cast<uint8_t>(std::min(rec.length, 81U));
+		put_(p + 54, 2, static_cast<uint16_t>(std::clamp(rec.rating, INT16_MIN, INT16_MAX)));
+		put_(p + 56, 4, rec.signature);
+		put_(p + 60, 4, static_cast<uint32_t>(rec.duration));
+	}
+
+	static void unpack( const uint8_t *p, SudokuRecord &rec )
+	{
+		for (size_t i = 0; i < rec.cells.size(); i++)
+		{
+			uint n = (p[i / 2] >> (i % 2 * 4)) & 0xF;
+			bool immutable = (p[41 + i / 8] >> (i % 8)) & 1;
+			rec.cells[i] = n == 0 || n > 9 ? '.' : static_cast<char>((immutable ? '0' : '@') + n);
+		}
+
+		rec.level     = p[52] <= Difficulty::Extreme ? static_cast<Difficulty>(p[52]) : Difficulty::Medium;
+		rec.length    = p[53];
+		rec.rating    = static_cast<int16_t>(get_(p + 54, 2));
+		rec.signature = static_cast<uint32_t>(get_(p + 56, 4));
+		rec.duration  = static_cast<int32_t>(get_(p + 60, 4));
+	}
+
+	class Writer
+	{
+		std::ofstream         file_;
+		std::vector<uint64_t> keys_;
+
+	public:
+
+		explicit Writer( const TCHAR *name ): file_{std::filesystem::path(name), std::ios::binary | std::ios::trunc}, keys_{}
+		{
+			uint8_t h[HeaderSize];
+			BoardArchive::header_(h, 0, 0);
+			file_.write(reinterpret_cast<const char *>(h), HeaderSize);
+		}
+
+		~Writer()
+		{
+			Writer::close();
+		}
+
+		bool is_open() const
+		{
+			return file_.is_open() && file_.good();
+		}
+
+		bool write( const SudokuRecord &rec )
+		{
+			if (!Writer::is_open() || keys_.size() > UINT32_MAX)
+				return false;
+
+			uint8_t p[RecordSize];
+			BoardArchive::pack(rec, p);
+			file_.write(reinterpret_cast<const char *>(p), RecordSize);
+
+			// sort key of the index entry: level, rating (descending), record number
+			auto rating = static_cast<uint64_t>(INT16_MAX - static_cast<int16_t>(get_(p + 54, 2)));
+			keys_.push_back(static_cast<uint64_t>(p[52]) << 48 | rating << 32 | keys_.size());
+			return true;
+		}
+
+		bool close()
+		{
+			if (!file_.is_open())
+				return false;
+
+			std::ranges::sort(keys_);
+			for (uint64_t k: keys_)
+			{
+				uint8_t e[EntrySize];
+				put_(e + 0, 4, k);
+				put_(e + 4, 2, static_cast<uint16_t>(INT16_MAX - static_cast<int>((k >> 32) & 0xFFFF)));
+				put_(e + 6, 1, k >> 48);
+				put_(e + 7, 1, 0);
+				file_.write(reinterpret_cast<const char *>(e), EntrySize);
+			}
+
+			uint8_t h[HeaderSize];
+			BoardArchive::header_(h, keys_.size(), HeaderSize + keys_.size() * RecordSize);
+			file_.seekp(0);
+			file_.write(reinterpret_cast<const char *>(h), HeaderSize);
+
+			bool result = file_.good();
+			file_.close();
+			keys_.clear();
+			return result;
+		}
+	};
+
+	explicit BoardArchive( const TCHAR *name ): file_{name}, count_{0}, records_{nullptr}, index_{nullptr}
+	{
+		auto p = reinterpret_cast<const uint8_t *>(file_.data());
+		if (file_.size() < HeaderSize || std::memcmp(p, Magic, sizeof(Magic)) != 0 ||
+		    get_(p + 8, 4) != Version || get_(p + 12, 4) != RecordSize)
+			return;
+
+		// the index must follow the records and end the file, and each of its entries must name a record
+		uint64_t count = get_(p + 16, 8);
+		uint64_t index = get_(p + 24, 8);
+		if (count > file_.size() / (RecordSize + EntrySize) ||
+		    index != HeaderSize + count * RecordSize || index + count * EntrySize != file_.size())
+			return;
+
+		for (uint64_t i = 0; i < count; i++)
+			if (get_(p + index + i * EntrySize, 4) >= count)
+				return;
+
+		count_   = count;
+		records_ = p + HeaderSize;
+		index_   = p + index;
+	}
+
+	bool is_open() const
+	{
+		return records_ != nullptr;
+	}
+
+	uint64_t size() const
+	{
+		return count_;
+	}
+
+	SudokuRecord at( const uint64_t i ) const
+	{
+		SudokuRecord rec;
+		BoardArchive::unpack(records_ + i * RecordSize, rec);
+		return rec;
+	}
+
+	// packed records, in the order they were written
+	std::string_view records() const
+	{
+		return { reinterpret_cast<const char *>(records_), static_cast<size_t>(count_ * RecordSize) };
+	}
+
+	// record number at the given position of the index
+	uint64_t entry( const uint64_t pos ) const
+	{
+		return get_(index_ + pos * EntrySize, 4);
+	}
+
+	// positions [first, last) of the index with records of the level rated from lo to hi
+	std::pair<uint64_t, uint64_t> find( const Difficulty level, const int lo = INT_MIN, const int hi = INT_MAX ) const
+	{
+		// first position not ordered before the entry (level, rating)
+		auto bound = [this, level]( const int64_t rating )
+		{
+			uint64_t first = 0;
+			for (uint64_t n = count_; n > 0; )
+			{
+				uint64_t half = n / 2;
+				uint64_t pos  = first + half;
+				if (level_(pos) < level || (level_(pos) == level && rating_(pos) > rating))
+				{
+					first = pos + 1;
+					n -= half + 1;
+				}
+				else
+					n = half;
+			}
+			return first;
+		};
+
+		uint64_t first = bound(hi);
+		uint64_t last  = bound(static_cast<int64_t>(lo) - 1);
+		return { first, std::max(first, last) };
+	}
+
+	// calls f(record) for every record of the archive; f returns false to stop
+	template<typename F>
+	size_t parse( F &&f ) const
+	{
+		SudokuRecord rec;
+		for (uint64_t i = 0; i < count_; i++)
+		{
+			BoardArchive::unpack(records_ + i * RecordSize, rec);
+			if (!f(rec))
+				return static_cast<size_t>(i + 1);
+		}
+
+		return static_cast<size_t>(count_);
+	}
+};
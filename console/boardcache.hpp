@@ -0,0 +1,250 @@
+/******************************************************************************
+
+   @file    boardcache.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardCache class: persistent cache of the rated layouts
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "mapfile.hpp"
+#include "platform.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+#include <filesystem>
+
+/*
+   The cache file is a memory-mapped open addressing hash table of fixed size records.
+   A record is written in place, its key is published last and every record carries
+   a check code, so a record torn by a crash is never trusted and is reused later.
+   The table grows by rehashing into a temporary file, which then replaces the cache.
+*/
+
+class BoardCache: public SudokuCache
+{
+	struct Header
+	{
+		char     magic[8];
+		uint32_t version;
+		uint32_t record;
+		uint64_t capacity;
+		uint64_t reserved[5];
+	};
+
+	struct Record
+	{
+		uint64_t key;
+		int32_t  rating;
+		uint32_t signature;
+		int32_t  level;
+		uint32_t check;
+		uint64_t reserved;
+	};
+
+	static_assert(sizeof(Header) == 64);
+	static_assert(sizeof(Record) == 32);
+
+	static constexpr char     Magic[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'C', 'H' };
+	static constexpr uint32_t Version  = 2;	// 2: keys of the exact layouts
+
+	std::basic_string<TCHAR> name_;
+	MappedFile               file_;
+	Record                  *table_;
+	uint64_t                 capacity_;
+	uint64_t                 count_;
+	std::mutex               lock_;
+
+	static uint32_t check_( const Record &r )
+	{
+		uint64_t x = r.key ^ (static_cast<uint64_t>(static_cast<uint32_t>(r.rating)) << 32 | r.signature);
+		x ^= static_cast<uint64_t>(static_cast<uint32_t>(r.level)) * 0x9E3779B97F4A7C15;
+		x ^= x >> 33; x *= 0xFF51AFD7ED558CCD;
+		x ^= x >> 33; x *= 0xC4CEB9FE1A85EC53;
+		x ^= x >> 33;
+		return static_cast<uint32_t>(x);
+	}
+
+	static bool valid_( Record &r )
+	{
+		return std::atomic_ref<uint64_t>(r.key).load(std::memory_order_acquire) != 0 && r.check == check_(r);
+	}
+
+	// the record with the given key or the free slot where it belongs
+	static Record *slot_( Record *table, const uint64_t capacity, const uint64_t key )
+	{
+		for (uint64_t i = key & (capacity - 1); ; i = (i + 1) & (capacity - 1))
+		{
+			Record &r = table[i];
+			if (!valid_(r) || r.key == key)
+				return &r;
+		}
+	}
+
+	static void write_( Record &r, const Record &src )
+	{
+		std::atomic_ref<uint64_t>(r.key).store(0, std::memory_order_relaxed);
+		r.rating    = src.rating;
+		r.signature = src.signature;
+		r.level     = src.level;
+		r.reserved  = 0;
+		r.check     = check_(src);
+		std::atomic_ref<uint64_t>(r.key).store(src.key, std::memory_order_release);
+	}
+
+	static bool map_( MappedFile &file, const TCHAR *name, uint64_t capacity )
+	{
+		if (!file.open(name, true, sizeof(Header) + capacity * sizeof(Record)))
+			return false;
+
+		Header *h = reinterpret_cast<Header *>(file.data());
+		if (h->version == 0 && h->capacity == 0)
+		{
+			h->version  = Version;
+			h->record   = sizeof(Record);
+			h->capacity = capacity;
+			std::memcpy(h->magic, Magic, sizeof(Magic));
+		}
+
+		return std::memcmp(h->magic, Magic, sizeof(Magic)) == 0 &&
+		       h->version == Version && h->record == sizeof(Record) &&
+		       h->capacity != 0 && (h->capacity & (h->capacity - 1)) == 0 &&
+		       sizeof(Header) + h->capacity * sizeof(Record) <= file.size();
+	}
+
+	bool open_( uint64_t capacity )
+	{
+		table_ = nullptr;
+		capacity_ = count_ = 0;
+
+		if (!BoardCache::map_(file_, name_.c_str(), capacity))
+			return file_.close(), false;
+
+		table_    = reinterpret_cast<Record *>(file_.data() + sizeof(Header));
+		capacity_ = reinterpret_cast<Header *>(file_.data())->capacity;
+		for (uint64_t i = 0; i < capacity_; i++)
+			if (valid_(table_[i]))
+				count_++;
+
+		return true;
+	}
+
+	bool grow_()
+	{
+		const uint64_t capacity = capacity_ * 2;
+
+		// a temporary file left by a crash may hold stale records or another capacity
+		std::error_code ec;
+		auto tmpname = name_ + _T(".tmp");
+		std::filesystem::remove(tmpname, ec);
+		if (ec)
+			return false;
+
+		auto tmp = MappedFile();
+		if (!BoardCache::map_(tmp, tmpname.c_str(), capacity) ||
+		     reinterpret_cast<Header *>(tmp.data())->capacity != capacity)
+			return false;
+
+		Record *table = reinterpret_cast<Record *>(tmp.data() + sizeof(Header));
+		for (uint64_t i = 0; i < capacity_; i++)
+			if (valid_(table_[i]))
+				write_(*slot_(table, capacity, table_[i].key), table_[i]);
+
+		if (!tmp.sync())
+			return false;
+		tmp.close();
+		file_.close();
+
+		std::filesystem::rename(tmpname, name_, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tmpname, ec);
+			BoardCache::open_(capacity_);	// keep working with the old table
+			return false;
+		}
+
+		return BoardCache::open_(capacity);
+	}
+
+public:
+
+	BoardCache( const TCHAR *name, const uint64_t capacity = 1 << 16 ): name_{name}, file_{}, table_{nullptr}, capacity_{0}, count_{0}, lock_{}
+	{
+		BoardCache::open_(std::bit_ceil(capacity));
+	}
+
+	~BoardCache()
+	{
+		file_.sync();
+	}
+
+	bool is_open()
+	{
+		return table_ != nullptr;
+	}
+
+	uint64_t size()
+	{
+		return count_;
+	}
+
+	bool find( uint64_t key, int &rating, Difficulty &level, uint32_t &signature ) override
+	{
+		auto guard = std::lock_guard(lock_);
+		if (table_ == nullptr)
+			return false;
+
+		Record *r = slot_(table_, capacity_, key);
+		if (!valid_(*r))
+			return false;
+
+		rating    = r->rating;
+		level     = static_cast<Difficulty>(r->level);
+		signature = r->signature;
+		return true;
+	}
+
+	void store( uint64_t key, int rating, Difficulty level, uint32_t signature ) override
+	{
+		auto guard = std::lock_guard(lock_);
+		if (table_ == nullptr)
+			return;
+
+		if ((count_ + 1) * 4 > capacity_ * 3 && !BoardCache::grow_())
+			return;
+
+		Record *r = slot_(table_, capacity_, key);
+		if (!valid_(*r))
+			count_++;
+
+		write_(*r, { key, rating, signature, level, 0, 0 });
+	}
+};
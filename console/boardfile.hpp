@@ -0,0 +1,141 @@
+/******************************************************************************
+
+   @file    boardfile.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardFile class: memory-mapped board file parser
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "mapfile.hpp"
+#include "platform.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+/*
+   Records are parsed directly from the mapped bytes of the board file, without
+   any allocation per line. The file can be split into line-aligned chunks
+   to be parsed by several threads at once. The name "-" stands for the standard input,
+   which is read line by line.
+*/
+
+class BoardFile
+{
+	MappedFile file_;
+
+public:
+
+	explicit BoardFile( const TCHAR *name ): file_{name} {}
+
+	bool is_open() const
+	{
+		return file_.is_open();
+	}
+
+	std::string_view view() const
+	{
+		return { file_.data(), file_.size() };
+	}
+
+	// at most n chunks, each of them starting at the beginning of a line
+	std::vector<std::string_view> chunks( const size_t n ) const
+	{
+		auto result = std::vector<std::string_view>();
+		auto data = BoardFile::view();
+		size_t step = data.size() / (n > 0 ? n : 1) + 1;
+
+		while (!data.empty())
+		{
+			size_t pos = data.find('\n', std::min(step, data.size()) - 1);
+			size_t len = pos == data.npos ? data.size() : pos + 1;
+			result.push_back(data.substr(0, len));
+			data.remove_prefix(len);
+		}
+
+		return result;
+	}
+
+	// parses the next non-empty line and removes it from the chunk
+	static bool next( std::string_view &chunk, SudokuRecord &rec )
+	{
+		while (!chunk.empty())
+		{
+			size_t eol = chunk.find('\n');
+			size_t len = eol == chunk.npos ? chunk.size() : eol;
+			bool result = rec.parse(chunk.data(), chunk.data() + len);
+			chunk.remove_prefix(std::min(len + 1, chunk.size()));
+			if (result)
+				return true;
+		}
+
+		return false;
+	}
+
+	// reads and parses the next non-empty line of the stream (e.g. stdin)
+	static bool next( std::FILE *file, SudokuRecord &rec )
+	{
+		char line[256];
+		while (std::fgets(line, sizeof(line), file) != nullptr)
+		{
+			size_t len = std::strlen(line);
+			if (len > 0 && line[len - 1] == '\n')
+				--len;
+			else
+				for (int c = std::fgetc(file); c != EOF && c != '\n'; c = std::fgetc(file));
+			if (rec.parse(line, line + len))
+				return true;
+		}
+
+		return false;
+	}
+
+	// true if the name stands for the standard input (output)
+	static bool is_stdio( const TCHAR *name )
+	{
+		return _tcscmp(name, _T("-")) == 0;
+	}
+
+	// calls f(record) for every non-empty line of the chunk; f returns false to stop
+	template<typename F>
+	static size_t parse( std::string_view chunk, F &&f )
+	{
+		size_t count = 0;
+		SudokuRecord rec;
+
+		while (BoardFile::next(chunk, rec))
+		{
+			count++;
+			if (!f(rec))
+				break;
+		}
+
+		return count;
+	}
+};
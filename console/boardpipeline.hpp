@@ -0,0 +1,177 @@
+/******************************************************************************
+
+   @file    boardpipeline.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardPipeline class: parallel rating of the boards
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "boardreader.hpp"
+#include "channel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+   Three stages connected by bounded channels: the reader, 'jobs' workers (each of them with its own board)
+   and the collector. A worker initializes its board with the record, calls the work function and passes
+   the layout on if the work function returns true. The work function can also mark the item as expired
+   (its budget has run out). The collector gets the items in the order of the input
+   (ordered) or as soon as they are done. In the ordered mode the workers take a record at most 'ahead'
+   positions past the first one not yet collected, so a slow board cannot make the reorder buffer grow without bound.
+*/
+
+class BoardPipeline
+{
+public:
+
+	struct Item
+	{
+		size_t       pos;	// position of the record in the input
+		bool         valid;
+		bool         expired;
+		SudokuRecord rec;
+		SudokuStats  stats;	// search effort of the work
+		SudokuAllocs allocs;	// heap allocations of the work
+	};
+
+private:
+
+	BoardReader             &reader_;
+	Channel<Item>            output_;
+	std::mutex               input_;
+	std::condition_variable  window_;
+	size_t                   ahead_;
+	size_t                   count_;
+	size_t                   collected_;	// position of the first item not yet collected (ordered)
+	bool                     ordered_;
+	bool                     stopped_;
+	std::atomic<size_t>      running_;
+	std::vector<std::thread> workers_;
+
+	template<typename F>
+	void work_( F work )
+	{
+		auto sudoku = Sudoku(Difficulty::Medium);
+		auto item   = Item();
+
+		for (;;)
+		{
+			{
+				auto guard = std::unique_lock(input_);
+				window_.wait(guard, [this]{ return stopped_ || !ordered_ || count_ < collected_ + ahead_; });
+				if (stopped_ || !reader_.next(item.rec))
+					break;
+				item.pos = count_++;
+			}
+
+			auto span = SudokuTrace::Span("board");
+			auto before = SudokuStats::local();
+			auto allocs = SudokuAllocs::local();
+			sudoku.init(item.rec);
+			item.expired = false;
+			item.valid = work(sudoku, item);
+			item.stats = SudokuStats::local() - before;
+			item.allocs = SudokuAllocs::local() - allocs;
+			if (item.valid)
+				item.rec = sudoku.record();
+			if (!output_.push(item))
+				break;
+		}
+
+		if (--running_ == 0)
+			output_.close();
+	}
+
+public:
+
+	template<typename F>
+	BoardPipeline( BoardReader &reader, const size_t jobs, F work, const size_t ahead = 1024 ):
+		reader_{reader}, output_{ahead}, input_{}, window_{}, ahead_{ahead > 0 ? ahead : 1}, count_{0}, collected_{0}, ordered_{true}, stopped_{false},
+		running_{jobs > 0 ? jobs : 1}, workers_{}
+	{
+		for (size_t i = running_; i > 0; i--)
+			workers_.emplace_back([this, work]{ BoardPipeline::work_(work); });
+	}
+
+	~BoardPipeline()
+	{
+		{
+			auto guard = std::lock_guard(input_);
+			stopped_ = true;
+		}
+		window_.notify_all();
+		output_.close();
+		for (auto &worker: workers_)
+			worker.join();
+	}
+
+	BoardPipeline( const BoardPipeline & ) = delete;
+	BoardPipeline &operator=( const BoardPipeline & ) = delete;
+
+	// calls f(item) for every record of the input
+	template<typename F>
+	void collect( const bool ordered, F &&f )
+	{
+		auto pending = std::map<size_t, Item>();
+		auto item    = Item();
+		size_t next  = 0;
+
+		if (!ordered)
+		{
+			{
+				auto guard = std::lock_guard(input_);
+				ordered_ = false;
+			}
+			window_.notify_all();
+		}
+
+		while (output_.pop(item))
+		{
+			if (!ordered)
+			{
+				f(item);
+				continue;
+			}
+
+			pending.emplace(item.pos, item);
+			for (auto i = pending.begin(); i != pending.end() && i->first == next; i = pending.erase(i), next++)
+				f(i->second);
+
+			{
+				auto guard = std::lock_guard(input_);
+				collected_ = next;
+			}
+			window_.notify_all();
+		}
+	}
+};
@@ -0,0 +1,151 @@
+/******************************************************************************
+
+   @file    boardreader.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardReader class: streaming reader of the board files
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "boardfile.hpp"
+#include "boardarchive.hpp"
+#include "channel.hpp"
+#include "platform.hpp"
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+
+/*
+   Records of the board files (or archives) are parsed by a separate thread, at most 'ahead' records
+   before the consumer, so the memory used does not depend on the size of the files.
+   A large board file is split into line-aligned chunks parsed by up to 'jobs' threads at once;
+   their records are passed on in the order of the file. Records can be consumed by several threads at once.
+*/
+
+class BoardReader
+{
+	static constexpr size_t Chunk = 1 << 20;	// smaller files are parsed by the reading thread alone
+
+	Channel<SudokuRecord> queue_;
+	size_t                ahead_;
+	size_t                jobs_;
+	std::thread           thread_;
+	std::atomic<size_t>   count_;
+
+	void parse_( const BoardFile &file )
+	{
+		auto push = [this]( const SudokuRecord &rec ){ return queue_.push(rec); };
+
+		size_t n = std::min(jobs_, file.view().size() / Chunk + 1);
+		if (n < 2)
+		{
+			BoardFile::parse(file.view(), push);
+			return;
+		}
+
+		auto chunks  = file.chunks(n);
+		auto parts   = std::deque<Channel<SudokuRecord>>();
+		auto parsers = std::vector<std::thread>();
+		for (size_t i = 0; i < chunks.size(); i++)
+			parts.emplace_back(ahead_ / chunks.size());
+		for (size_t i = 0; i < chunks.size(); i++)
+			parsers.emplace_back([&chunks, &parts, i]
+			{
+				BoardFile::parse(chunks[i], [&part = parts[i]]( const SudokuRecord &rec ){ return part.push(rec); });
+				parts[i].close();
+			});
+
+		// stops the parsers too, if the consumer has stopped
+		bool running = true;
+		SudokuRecord rec;
+		for (auto &part: parts)
+			while (running && part.pop(rec))
+				running = push(rec);
+
+		for (auto &part: parts)
+			part.close();
+		for (auto &parser: parsers)
+			parser.join();
+	}
+
+	void read_( const std::vector<const TCHAR *> files )
+	{
+		static SudokuLatency latency("read");
+
+		auto push = [this]( const SudokuRecord &rec ){ return queue_.push(rec); };
+
+		for (const TCHAR *name: files)
+		{
+			auto timer = SudokuLatency::Timer(latency);
+			auto span = SudokuTrace::Span("read");
+
+			if (BoardFile::is_stdio(name))
+			{
+				SudokuRecord rec;
+				while (BoardFile::next(stdin, rec) && push(rec));
+				continue;
+			}
+
+			auto archive = BoardArchive(name);
+			if (archive.is_open())
+				archive.parse(push);
+			else
+				BoardReader::parse_(BoardFile(name));
+		}
+
+		queue_.close();
+	}
+
+public:
+
+	BoardReader( const std::vector<const TCHAR *> &files, const size_t jobs = 1, const size_t ahead = 1024 ): queue_{ahead}, ahead_{ahead}, jobs_{jobs}, thread_{}, count_{0}
+	{
+		thread_ = std::thread(&BoardReader::read_, this, files);
+	}
+
+	~BoardReader()
+	{
+		queue_.close();
+		thread_.join();
+	}
+
+	bool next( SudokuRecord &rec )
+	{
+		if (!queue_.pop(rec))
+			return false;
+
+		count_++;
+		return true;
+	}
+
+	size_t count()
+	{
+		return count_;
+	}
+};
@@ -0,0 +1,171 @@
+/******************************************************************************
+
+   @file    boardsink.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardSink class: buffered output of the boards
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "gametimer.hpp"
+#include "platform.hpp"
+#include <cstdio>
+#include <sstream>
+#include <iostream>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+   Boards are collected in memory and written in batches: when 'batch' boards are pending
+   or when 'interval' milliseconds have passed since the last write. With 'sync' set, every
+   batch is also committed to the disk, so a crash loses at most the pending batch.
+*/
+
+class BoardSink
+{
+	std::FILE                   *file_;
+	bool                         owner_;
+	bool                         sync_;
+	size_t                       batch_;
+	int                          interval_;
+	size_t                       pending_;
+	std::ostringstream           buffer_;
+	GameTimer<int, std::milli>   timer_;
+
+	void written_()
+	{
+		if (++pending_ >= batch_)
+			BoardSink::flush();
+		else
+			BoardSink::tick();
+	}
+
+public:
+
+	BoardSink( std::FILE *file, const bool sync = false, const size_t batch = 256, const int interval = 1000 ):
+		file_{file}, owner_{false}, sync_{sync}, batch_{batch}, interval_{interval}, pending_{0}, buffer_{}, timer_{} {}
+
+	// the name "-" stands for the standard output
+	BoardSink( const TCHAR *name, const bool sync = false, const size_t batch = 256, const int interval = 1000 ):
+		BoardSink(_tcscmp(name, _T("-")) == 0 ? stdout : _tfopen(name, _T("a")), sync, batch, interval)
+	{
+		owner_ = file_ != stdout;
+	}
+
+	~BoardSink()
+	{
+		BoardSink::flush();
+		if (owner_ && file_ != nullptr)
+			std::fclose(file_);
+	}
+
+	BoardSink( const BoardSink & ) = delete;
+	BoardSink &operator=( const BoardSink & ) = delete;
+
+	bool is_open() const
+	{
+		return file_ != nullptr;
+	}
+
+	template<class T>
+	void write( T &board )
+	{
+		buffer_ << board << '\n';
+		BoardSink::written_();
+	}
+
+	// the board followed by its number in the input (ignored when the board is read back)
+	template<class T>
+	void write( T &board, const size_t number )
+	{
+		buffer_ << board << " #" << number << '\n';
+		BoardSink::written_();
+	}
+
+	// writes the pending boards if the interval has passed
+	void tick()
+	{
+		if (pending_ > 0 && timer_.expired(interval_))
+			BoardSink::flush();
+	}
+
+	bool flush()
+	{
+		if (file_ == nullptr)
+			return false;
+
+		bool result = true;
+		if (pending_ > 0)
+		{
+			static SudokuLatency latency("write");
+			auto timer = SudokuLatency::Timer(latency);
+			auto span = SudokuTrace::Span("write");
+			auto data = buffer_.view();
+			result = std::fwrite(data.data(), 1, data.size(), file_) == data.size();
+			buffer_.str({});
+			pending_ = 0;
+		}
+
+		result = std::fflush(file_) == 0 && result;
+		if (sync_ && result)
+		#if defined(_WIN32)
+			result = _commit(_fileno(file_)) == 0;
+		#else
+			result = fsync(fileno(file_)) == 0;
+		#endif
+
+		timer_.restart();
+		return result;
+	}
+};
+
+/*
+   Progress of a batch mode, shown at most every 'interval' milliseconds.
+*/
+
+class Progress
+{
+	int                          interval_;
+	GameTimer<int, std::milli>   timer_;
+
+public:
+
+	explicit Progress( const int interval = 250 ): interval_{interval}, timer_{} {}
+
+	void operator()( const size_t count )
+	{
+		if (timer_.expired(interval_, false))
+		{
+			std::cerr << ' ' << count << '\r';
+			timer_.restart();
+		}
+	}
+};
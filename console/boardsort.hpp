@@ -0,0 +1,350 @@
+/******************************************************************************
+
+   @file    boardsort.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardSort class: external merge sort of the boards
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include "mapfile.hpp"
+#include "boardfile.hpp"
+#include "boardarchive.hpp"
+#include "platform.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/*
+   Records are sorted in memory-bounded runs by their packed sort keys (radix sort of the keys,
+   then permutation of the records). When a run is full, it is sorted and spilled
+   to a temporary file of packed records; finally all runs are merged (k-way merge).
+   The same merge step combines already sorted board files (or archives) directly.
+   BoardTop keeps only the best records of the stream in a bounded heap.
+*/
+
+class BoardSort
+{
+public:
+
+	using Order = uint64_t (*)( const SudokuRecord & );
+
+private:
+
+	// sequential reader of the stream, the text lines or the packed records
+	class Cursor
+	{
+		std::string_view data_;
+		bool             packed_;
+		std::FILE       *file_;
+
+	public:
+
+		SudokuRecord rec;
+		uint64_t     key;
+
+		Cursor( const std::string_view data, const bool packed ): data_{data}, packed_{packed}, file_{nullptr}, rec{}, key{} {}
+		Cursor( std::FILE *file ): data_{}, packed_{false}, file_{file}, rec{}, key{} {}
+
+		bool next( const Order order )
+		{
+			if (file_ != nullptr)
+			{
+				if (!BoardFile::next(file_, rec))
+					return false;
+			}
+			else
+			if (!packed_)
+			{
+				if (!BoardFile::next(data_, rec))
+					return false;
+			}
+			else
+			{
+				if (data_.size() < BoardArchive::RecordSize)
+					return false;
+
+				BoardArchive::unpack(reinterpret_cast<const uint8_t *>(data_.data()), rec);
+				data_.remove_prefix(BoardArchive::RecordSize);
+			}
+
+			key = order(rec);
+			return true;
+		}
+	};
+
+	struct Item
+	{
+		uint64_t key;
+		size_t   pos;
+	};
+
+	Order                                 order_;
+	size_t                                limit_;
+	std::vector<SudokuRecord>             run_;
+	std::vector<std::filesystem::path>    runs_;
+
+	// LSD radix sort of the keys (8 bits per pass, passes with a single bucket are skipped)
+	static void radix_( std::vector<Item> &items )
+	{
+		auto temp = std::vector<Item>(items.size());
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			size_t count[256] = {};
+			for (const Item &item: items)
+				count[(item.key >> shift) & 0xFF]++;
+			if (std::find(std::begin(count), std::end(count), items.size()) != std::end(count))
+				continue;
+
+			size_t pos = 0;
+			for (size_t &c: count)
+				pos += std::exchange(c, pos);
+			for (const Item &item: items)
+				temp[count[(item.key >> shift) & 0xFF]++] = item;
+			items.swap(temp);
+		}
+	}
+
+	void sort_()
+	{
+		auto items = std::vector<Item>(run_.size());
+		for (size_t i = 0; i < run_.size(); i++)
+			items[i] = { order_(run_[i]), i };
+
+		BoardSort::radix_(items);
+
+		auto sorted = std::vector<SudokuRecord>(run_.size());
+		for (size_t i = 0; i < items.size(); i++)
+			sorted[i] = run_[items[i].pos];
+		run_.swap(sorted);
+	}
+
+	bool spill_()
+	{
+		auto span = SudokuTrace::Span("spill");
+		BoardSort::sort_();
+
+		auto name = std::string("sudoku-") + std::to_string(std::random_device{}()) + '-' + std::to_string(runs_.size()) + ".run";
+		auto path = std::filesystem::temp_directory_path() / name;
+		auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		runs_.push_back(path);
+
+		uint8_t p[BoardArchive::RecordSize];
+		for (const SudokuRecord &rec: run_)
+		{
+			BoardArchive::pack(rec, p);
+			file.write(reinterpret_cast<const char *>(p), BoardArchive::RecordSize);
+		}
+
+		run_.clear();
+		return file.good();
+	}
+
+	template<typename F>
+	static void merge_( std::vector<Cursor> &cursors, const Order order, F &&f )
+	{
+		auto span = SudokuTrace::Span("merge");
+
+		// the smallest key on the top, equal keys in the order of the cursors
+		auto after = [&cursors]( const size_t a, const size_t b )
+		{
+			return cursors[b].key < cursors[a].key || (cursors[a].key == cursors[b].key && b < a);
+		};
+
+		auto heap = std::priority_queue<size_t, std::vector<size_t>, decltype(after)>(after);
+		for (size_t i = 0; i < cursors.size(); i++)
+			if (cursors[i].next(order))
+				heap.push(i);
+
+		while (!heap.empty())
+		{
+			size_t i = heap.top();
+			heap.pop();
+			f(cursors[i].rec);
+			if (cursors[i].next(order))
+				heap.push(i);
+		}
+	}
+
+public:
+
+	// the run, its sorted copy and the keys must fit in the memory limit
+	BoardSort( const Order order, const size_t memory ): order_{order}, limit_{std::max<size_t>(memory / (2 * sizeof(SudokuRecord) + 2 * sizeof(Item)), 1)}, run_{}, runs_{} {}
+
+	~BoardSort()
+	{
+		std::error_code ec;
+		for (auto &path: runs_)
+			std::filesystem::remove(path, ec);
+	}
+
+	BoardSort( const BoardSort & ) = delete;
+	BoardSort &operator=( const BoardSort & ) = delete;
+
+	bool push( const SudokuRecord &rec )
+	{
+		run_.push_back(rec);
+		return run_.size() < limit_ || BoardSort::spill_();
+	}
+
+	size_t runs()
+	{
+		return runs_.size();
+	}
+
+	// calls f(record) for every pushed record in the sorted order
+	template<typename F>
+	bool merge( F &&f )
+	{
+		if (runs_.empty())
+		{
+			BoardSort::sort_();
+			std::for_each(run_.begin(), run_.end(), f);
+			return true;
+		}
+
+		bool result = run_.empty() || BoardSort::spill_();
+
+		auto files   = std::vector<MappedFile>(runs_.size());
+		auto cursors = std::vector<Cursor>();
+		for (size_t i = 0; i < runs_.size(); i++)
+		{
+			result = files[i].open(runs_[i].string<TCHAR>().c_str()) && result;
+			cursors.emplace_back(std::string_view(files[i].data(), files[i].size()), true);
+		}
+
+		BoardSort::merge_(cursors, order_, f);
+		return result;
+	}
+
+	// calls f(record) for every record of the sorted board files (or archives) in the sorted order
+	template<typename F>
+	static bool merge( const std::vector<const TCHAR *> &names, const Order order, F &&f )
+	{
+		bool result = true;
+
+		auto archives = std::vector<std::unique_ptr<BoardArchive>>();
+		auto files    = std::vector<std::unique_ptr<BoardFile>>();
+		auto cursors  = std::vector<Cursor>();
+		for (const TCHAR *name: names)
+		{
+			if (BoardFile::is_stdio(name))
+			{
+				cursors.emplace_back(stdin);
+				continue;
+			}
+
+			auto &archive = archives.emplace_back(std::make_unique<BoardArchive>(name));
+			if (archive->is_open())
+			{
+				cursors.emplace_back(archive->records(), true);
+				continue;
+			}
+
+			auto &file = files.emplace_back(std::make_unique<BoardFile>(name));
+			result = file->is_open() && result;
+			cursors.emplace_back(file->view(), false);
+		}
+
+		BoardSort::merge_(cursors, order, f);
+		return result;
+	}
+};
+
+class BoardTop
+{
+	struct Item
+	{
+		uint64_t     key;
+		SudokuRecord rec;
+	};
+
+	BoardSort::Order             order_;
+	size_t                       limit_;
+	std::vector<Item>            heap_;
+	std::unordered_set<uint32_t> data_;
+
+	// the worst record on the top of the heap
+	static bool by_key_( const Item &a, const Item &b )
+	{
+		return a.key < b.key;
+	}
+
+public:
+
+	BoardTop( const BoardSort::Order order, const size_t limit ): order_{order}, limit_{limit}, heap_{}, data_{}
+	{
+		heap_.reserve(limit);
+	}
+
+	// returns false if the record is a duplicate of the heap content or is not good enough
+	bool push( const SudokuRecord &rec )
+	{
+		if (limit_ == 0 || data_.contains(rec.signature))
+			return false;
+
+		uint64_t key = order_(rec);
+		if (heap_.size() == limit_)
+		{
+			if (key >= heap_.front().key)
+				return false;
+
+			std::pop_heap(heap_.begin(), heap_.end(), BoardTop::by_key_);
+			data_.erase(heap_.back().rec.signature);
+			heap_.pop_back();
+		}
+
+		heap_.push_back({ key, rec });
+		std::push_heap(heap_.begin(), heap_.end(), BoardTop::by_key_);
+		data_.insert(rec.signature);
+		return true;
+	}
+
+	size_t size()
+	{
+		return heap_.size();
+	}
+
+	// calls f(record) for every selected record in the sorted order
+	template<typename F>
+	void select( F &&f )
+	{
+		std::sort_heap(heap_.begin(), heap_.end(), BoardTop::by_key_);
+		for (const Item &item: heap_)
+			f(item.rec);
+	}
+};
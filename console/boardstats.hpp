@@ -0,0 +1,182 @@
+/******************************************************************************
+
+   @file    boardstats.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   BoardStats class: histograms of the board corpus
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "sudoku.hpp"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <iostream>
+#include <utility>
+
+/*
+   Statistics are collected by each worker thread separately (add) and merged at the end (merge).
+   Divergence is the difference between the exact rating and the rating stored in the board file.
+*/
+
+class BoardStats
+{
+	static constexpr const char *names_[] = { "easy", "medium", "hard", "expert", "extreme" };
+	static constexpr int width_ = 100;
+
+	size_t                                 count_;
+	size_t                                 changed_;
+	std::array<size_t, 5>                  level_;
+	std::array<size_t, 82>                 length_;
+	std::map<int, size_t>                  rating_;
+	std::map<int, size_t>                  divergence_;
+	std::unordered_map<uint32_t, uint32_t> signature_;
+
+	static int bucket_( const int value )
+	{
+		return value < 0 ? -((width_ - 1 - value) / width_) * width_ : value / width_ * width_;
+	}
+
+	// number of signature groups by size (1 - unique, 2 - shared by two boards, ...)
+	std::map<uint32_t, size_t> groups_() const
+	{
+		auto result = std::map<uint32_t, size_t>();
+		for (auto &s: signature_)
+			result[s.second]++;
+		return result;
+	}
+
+	static std::map<int, size_t> buckets_( const std::map<int, size_t> &values )
+	{
+		auto result = std::map<int, size_t>();
+		for (auto &v: values)
+			result[BoardStats::bucket_(v.first)] += v.second;
+		return result;
+	}
+
+public:
+
+	BoardStats(): count_{0}, changed_{0}, level_{}, length_{}, rating_{}, divergence_{}, signature_{} {}
+
+	void add( const SudokuRecord &stored, const SudokuRecord &exact )
+	{
+		count_++;
+		if (exact.level > Difficulty::Any && exact.level <= Difficulty::Extreme)
+			level_[static_cast<size_t>(exact.level)]++;
+		if (exact.level != stored.level)
+			changed_++;
+		length_[std::min<size_t>(exact.length, 81)]++;
+		rating_[exact.rating]++;
+		divergence_[exact.rating - stored.rating]++;
+		signature_[exact.signature]++;
+	}
+
+	void merge( const BoardStats &other )
+	{
+		count_   += other.count_;
+		changed_ += other.changed_;
+		for (size_t i = 0; i < level_.size(); i++)  level_[i]  += other.level_[i];
+		for (size_t i = 0; i < length_.size(); i++) length_[i] += other.length_[i];
+		for (auto &v: other.rating_)     rating_[v.first]     += v.second;
+		for (auto &v: other.divergence_) divergence_[v.first] += v.second;
+		for (auto &v: other.signature_)  signature_[v.first]  += v.second;
+	}
+
+	size_t size()
+	{
+		return count_;
+	}
+
+	template<class T>
+	void report( std::basic_ostream<T> &out ) const
+	{
+		out << "boards:     " << count_ << '\n';
+
+		out << "level:     ";
+		for (size_t i = 0; i < level_.size(); i++)
+			out << ' ' << names_[i] << ' ' << level_[i];
+		out << "\nclues:     ";
+		for (size_t i = 0; i < length_.size(); i++)
+			if (length_[i] > 0)
+				out << ' ' << i << ':' << length_[i];
+
+		out << "\nrating:    ";
+		if (!rating_.empty())
+		{
+			long long sum = 0;
+			for (auto &v: rating_)
+				sum += static_cast<long long>(v.first) * static_cast<long long>(v.second);
+			out << " min " << rating_.begin()->first << " max " << rating_.rbegin()->first
+			    << " mean " << sum / static_cast<long long>(count_) << " |";
+			for (auto &v: BoardStats::buckets_(rating_))
+				out << ' ' << v.first << ':' << v.second;
+		}
+
+		out << "\nsignatures: " << signature_.size() << " distinct |";
+		for (auto &v: BoardStats::groups_())
+			out << ' ' << v.first << 'x' << ':' << v.second;
+
+		out << "\ndivergence: " << changed_ << " levels changed |";
+		for (auto &v: BoardStats::buckets_(divergence_))
+			out << ' ' << v.first << ':' << v.second;
+
+		out << std::endl;
+	}
+
+	template<class T>
+	void json( std::basic_ostream<T> &out ) const
+	{
+		auto object = [&out]( const auto &values )
+		{
+			const char *sep = "";
+			out << '{';
+			for (auto &v: values)
+				out << std::exchange(sep, ",") << '"' << v.first << "\":" << v.second;
+			out << '}';
+		};
+
+		out << "{\"boards\":" << count_ << ",\"level\":{";
+		for (size_t i = 0; i < level_.size(); i++)
+			out << (i > 0 ? "," : "") << '"' << names_[i] << "\":" << level_[i];
+
+		out << "},\"clues\":";
+		auto clues = std::map<size_t, size_t>();
+		for (size_t i = 0; i < length_.size(); i++)
+			if (length_[i] > 0)
+				clues[i] = length_[i];
+		object(clues);
+
+		out << ",\"rating\":";
+		object(BoardStats::buckets_(rating_));
+		out << ",\"signatures\":{\"distinct\":" << signature_.size() << ",\"groups\":";
+		object(BoardStats::groups_());
+		out << "},\"divergence\":{\"levels\":" << changed_ << ",\"rating\":";
+		object(BoardStats::buckets_(divergence_));
+		out << "}}" << std::endl;
+	}
+};
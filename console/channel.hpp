@@ -0,0 +1,87 @@
+/******************************************************************************
+
+   @file    channel.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   Channel class: bounded queue between threads
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+template<typename T>
+class Channel
+{
+	std::deque<T>           queue_;
+	size_t                  capacity_;
+	bool                    closed_;
+	std::mutex              lock_;
+	std::condition_variable readable_;
+	std::condition_variable writable_;
+
+public:
+
+	explicit Channel( const size_t capacity ): queue_{}, capacity_{capacity > 0 ? capacity : 1}, closed_{false} {}
+
+	// blocks while the channel is full; fails if the channel has been closed
+	bool push( T value )
+	{
+		auto guard = std::unique_lock(lock_);
+		writable_.wait(guard, [this]{ return closed_ || queue_.size() < capacity_; });
+		if (closed_)
+			return false;
+
+		queue_.push_back(std::move(value));
+		readable_.notify_one();
+		return true;
+	}
+
+	// blocks while the channel is empty; fails if the channel has been closed and drained
+	bool pop( T &value )
+	{
+		auto guard = std::unique_lock(lock_);
+		readable_.wait(guard, [this]{ return closed_ || !queue_.empty(); });
+		if (queue_.empty())
+			return false;
+
+		value = std::move(queue_.front());
+		queue_.pop_front();
+		writable_.notify_one();
+		return true;
+	}
+
+	void close()
+	{
+		auto guard = std::lock_guard(lock_);
+		closed_ = true;
+		readable_.notify_all();
+		writable_.notify_all();
+	}
+};
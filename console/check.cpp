@@ -0,0 +1,106 @@
+/******************************************************************************
+
+   @file    check.cpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   Sudoku engine checks
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#include "sudoku.hpp"
+#include "platform.hpp"
+#include <iostream>
+#include <string>
+
+using Cell = SudokuCell;
+
+/*
+   Checks of the engine that are not covered by the batch modes; every failed check is reported
+   and the exit code is the number of the failures.
+*/
+
+static int failures = 0;
+
+static void check( const bool cond, const char *what )
+{
+	if (!cond)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+// a saved game with a wrong entry of the player: the solution must not be used for solve() and hint()
+static void check_loaded_mistake()
+{
+	const std::string layout = "...7..36....2...7...7..8....4..2.18...21.6......9.4....1...284.9...3............7";
+
+	auto sudoku = Sudoku(Difficulty::Medium);
+	sudoku.init(layout.data(), layout.size());
+
+	// an empty cell and a digit keeping the rules but other than the solution
+	Cell *cell  = nullptr;
+	uint  digit = 0;
+	for (Cell &c: sudoku)
+	{
+		for (uint v = 1; v <= 9 && cell == nullptr; v++)
+		{
+			if (v != sudoku.answer(&c) && c.allowed(v))
+			{
+				cell  = &c;
+				digit = v;
+			}
+		}
+	}
+	check(cell != nullptr, "a wrong digit keeping the rules");
+	if (cell == nullptr)
+		return;
+
+	auto game = layout;
+	game[cell->pos] = static_cast<char>('@' + digit);
+	sudoku.init(game.data(), game.size());
+
+	check(cell->num == digit && !cell->immutable, "the entry of the player is loaded");
+	check(sudoku.mistake(cell), "the entry of the player is a mistake");
+	check(sudoku.wrong() > 0, "the mistakes are counted after loading");
+
+	for (Cell &c: sudoku)
+		if (c.num == 0)
+			check(sudoku.hint(&c) == c.sure(), "hint() is not taken from the solution");
+
+	auto len = sudoku.len();
+	sudoku.solve();
+	check(cell->num == digit, "solve() keeps the entry of the player");
+	check(sudoku.len() == len, "solve() leaves the board with a mistake untouched");
+	check(!sudoku.finished(), "the board with a mistake is not finished");
+}
+
+int _tmain( int, TCHAR ** )
+{
+	check_loaded_mistake();
+
+	std::cerr << (failures == 0 ? "all checks passed" : "some checks failed") << std::endl;
+	return failures;
+}
@@ -0,0 +1,181 @@
+/******************************************************************************
+
+   @file    mapfile.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   MappedFile class
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#include "platform.hpp"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile
+{
+	char  *data_;
+	size_t size_;
+#if defined(_WIN32)
+	HANDLE file_;
+	HANDLE map_;
+#else
+	int    file_;
+#endif
+
+public:
+
+	MappedFile(): data_{nullptr}, size_{0},
+#if defined(_WIN32)
+		file_{INVALID_HANDLE_VALUE}, map_{nullptr}
+#else
+		file_{-1}
+#endif
+	{}
+
+	MappedFile( const TCHAR *name, const bool writable = false, const size_t size = 0 ): MappedFile()
+	{
+		open(name, writable, size);
+	}
+
+	~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile( const MappedFile & ) = delete;
+	MappedFile &operator=( const MappedFile & ) = delete;
+
+	// writable: the file is created if needed and extended to the given size (never truncated)
+	bool open( const TCHAR *name, const bool writable = false, size_t size = 0 )
+	{
+		close();
+
+	#if defined(_WIN32)
+		file_ = CreateFile(name, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		                   nullptr, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER length;
+		if (!GetFileSizeEx(file_, &length))
+			return close(), false;
+		if (size < static_cast<size_t>(length.QuadPart))
+			size = static_cast<size_t>(length.QuadPart);
+		if (size == 0)
+			return true;
+
+		map_ = CreateFileMapping(file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+		                         static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), nullptr);
+		if (map_ == nullptr)
+			return close(), false;
+
+		data_ = static_cast<char *>(MapViewOfFile(map_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+		if (data_ == nullptr)
+			return close(), false;
+	#else
+		file_ = ::open(name, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+		if (file_ < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(file_, &st) != 0)
+			return close(), false;
+		if (size < static_cast<size_t>(st.st_size))
+			size = static_cast<size_t>(st.st_size);
+		else
+		if (size > static_cast<size_t>(st.st_size) && ftruncate(file_, static_cast<off_t>(size)) != 0)
+			return close(), false;
+		if (size == 0)
+			return true;
+
+		void *data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file_, 0);
+		if (data == MAP_FAILED)
+			return close(), false;
+
+		data_ = static_cast<char *>(data);
+		if (!writable)
+			madvise(data, size, MADV_SEQUENTIAL);
+	#endif
+
+		size_ = size;
+		return true;
+	}
+
+	void close()
+	{
+	#if defined(_WIN32)
+		if (data_ != nullptr)                UnmapViewOfFile(data_);
+		if (map_  != nullptr)                CloseHandle(map_);
+		if (file_ != INVALID_HANDLE_VALUE)   CloseHandle(file_);
+		map_  = nullptr;
+		file_ = INVALID_HANDLE_VALUE;
+	#else
+		if (data_ != nullptr)                munmap(data_, size_);
+		if (file_ >= 0)                      ::close(file_);
+		file_ = -1;
+	#endif
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+	// write the dirty pages back to the disk
+	bool sync()
+	{
+		if (data_ == nullptr)
+			return true;
+
+	#if defined(_WIN32)
+		return FlushViewOfFile(data_, size_) && FlushFileBuffers(file_);
+	#else
+		return msync(data_, size_, MS_SYNC) == 0;
+	#endif
+	}
+
+	bool is_open() const
+	{
+	#if defined(_WIN32)
+		return file_ != INVALID_HANDLE_VALUE;
+	#else
+		return file_ >= 0;
+	#endif
+	}
+
+	char       *data()       { return data_; }
+	const char *data() const { return data_; }
+	size_t      size() const { return size_; }
+	const char *begin() const { return data_; }
+	const char *end()   const { return data_ + size_; }
+};
@@ -0,0 +1,187 @@
+/******************************************************************************
+
+   @file    perfcounters.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   PerfCounters class
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/*
+   Hardware counters of the calling thread (user space only) through perf_event_open on Linux.
+   Every counter is opened separately; the ones refused by the kernel or the hardware (virtual
+   machines, perf_event_paranoid, other systems) are simply not available.
+*/
+
+class PerfCounters
+{
+public:
+
+	enum Counter
+	{
+		Cycles,
+		Instructions,
+		BranchMisses,
+		L1Misses,
+		LLCMisses,
+		Count
+	};
+
+	static constexpr const char *names[] = { "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses" };
+
+	using Values = std::array<uint64_t, Count>;
+
+private:
+
+	std::array<int, Count> fd_;
+	int                    error_;
+
+#if defined(__linux__)
+	static int open_( const uint32_t type, const uint64_t config )
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size           = sizeof(attr);
+		attr.type           = type;
+		attr.config         = config;
+		attr.disabled       = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv     = 1;
+		attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	static constexpr uint64_t cache_( const uint64_t cache )
+	{
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+#endif
+
+public:
+
+	PerfCounters(): fd_{}, error_{0}
+	{
+		fd_.fill(-1);
+	#if defined(__linux__)
+		static constexpr std::pair<uint32_t, uint64_t> events[] =
+		{
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+			{ PERF_TYPE_HW_CACHE, cache_(PERF_COUNT_HW_CACHE_L1D) },
+			{ PERF_TYPE_HW_CACHE, cache_(PERF_COUNT_HW_CACHE_LL) },
+		};
+
+		for (size_t i = 0; i < Count; i++)
+			if ((fd_[i] = open_(events[i].first, events[i].second)) < 0 && error_ == 0)
+				error_ = errno;
+	#else
+		error_ = -1;
+	#endif
+	}
+
+	~PerfCounters()
+	{
+	#if defined(__linux__)
+		for (int fd: fd_)
+			if (fd >= 0)
+				::close(fd);
+	#endif
+	}
+
+	PerfCounters( const PerfCounters & ) = delete;
+	PerfCounters &operator=( const PerfCounters & ) = delete;
+
+	bool available( const Counter c ) const
+	{
+		return fd_[c] >= 0;
+	}
+
+	bool any() const
+	{
+		for (int fd: fd_)
+			if (fd >= 0)
+				return true;
+		return false;
+	}
+
+	// reason of the first refused counter
+	const char *error() const
+	{
+	#if defined(__linux__)
+		if (error_ > 0)
+			return std::strerror(error_);
+	#endif
+		return error_ == 0 ? "" : "not supported on this system";
+	}
+
+	void start()
+	{
+	#if defined(__linux__)
+		for (int fd: fd_)
+			if (fd >= 0)
+			{
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+	#endif
+	}
+
+	// counts since start(), scaled up when the kernel had to multiplex the counters
+	Values stop()
+	{
+		Values result{};
+	#if defined(__linux__)
+		for (int fd: fd_)
+			if (fd >= 0)
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			uint64_t data[3];	// value, time enabled, time running
+			if (fd_[i] < 0 || ::read(fd_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+				continue;
+			result[i] = data[2] == 0 || data[2] == data[1] ? data[0] :
+			            static_cast<uint64_t>(static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]));
+		}
+	#endif
+		return result;
+	}
+};
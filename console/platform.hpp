@@ -0,0 +1,65 @@
+/******************************************************************************
+
+   @file    platform.hpp
+   @author  Rajmund Szymanski
+   @date    18.10.2026
+   @brief   platform dependent definitions
+
+*******************************************************************************
+
+   Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+******************************************************************************/
+
+#pragma once
+
+#if defined(_WIN32)
+#include <tchar.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+#include <iostream>
+
+/*
+   On systems without <tchar.h> the text is char-based (as without UNICODE on Windows).
+*/
+
+#if !defined(_WIN32)
+typedef char TCHAR;
+#if !defined(_T)
+#define _T(x)     x
+#endif
+#define _tmain    main
+#define _tcslen   std::strlen
+#define _tcscmp   std::strcmp
+#define _tcstol   std::strtol
+#define _tcstoul  std::strtoul
+#define _tfopen   std::fopen
+#endif
+
+// error stream of TCHAR text
+#if defined(_UNICODE)
+inline std::wostream &tcerr = std::wcerr;
+#else
+inline std::ostream  &tcerr = std::cerr;
+#endif
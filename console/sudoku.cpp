@@ -33,14 +33,14 @@
 #include "sudoku.hpp"
 #include "console.hpp"
 #include "gametimer.hpp"
+#include "batch.hpp"
+#include "alloctrack.hpp"
 #include <iostream>
 #include <iomanip>
 #include <tchar.h>
 
 using Cell = SudokuCell;
 
-const TCHAR *title = _T("Sudoku");
-
 const Console::Rect TAB(0, 1, 25, 13);
 const Console::Rect MNU(TAB.right, TAB.top, 14, TAB.height);
 const Console::Rect HDR(TAB.left, 0, MNU.right - TAB.left, TAB.top);
@@ -125,7 +125,7 @@ public:
 
 	GameCell( const int _x, const int _y, Cell* const _c ): x{_x}, y{_y}, cell{_c}, focused{false} {}
 
-	void    update      ( Console &, const bool, const uint, const Assistance, Cell* const, const bool );
+	void    update      ( Console &, const bool, const uint, const Assistance, Cell* const, const bool, const Sudoku::Singles & );
 	void    mouseMove   ( const int, const int );
 	Command mouseLButton( const int, const int, const uint, const Assistance );
 	Command mouseRButton( const int, const int );
@@ -140,7 +140,7 @@ public:
 
 	GameTable( Sudoku & );
 
-	void    update      ( Console &, const bool, const uint, const Assistance, Cell* const, const bool );
+	void    update      ( Console &, const bool, const uint, const Assistance, Cell* const, const bool, const Sudoku::Singles & );
 	void    mouseMove   ( const int, const int );
 	Command mouseLButton( const int, const int, const uint, const Assistance );
 	Command mouseRButton( const int, const int );
@@ -270,7 +270,7 @@ Command GameHeader::mouseLButton( const int _x, const int _y )
 
 /*---------------------------------------------------------------------------*/
 
-void GameCell::update( Console &con, const bool, const uint number, const Assistance help, Cell* const focus, const bool light )
+void GameCell::update( Console &con, const bool, const uint number, const Assistance help, Cell* const focus, const bool light, const Sudoku::Singles &singles )
 {
 	auto l = GameCell::focused || (light && GameCell::cell->linked(focus));
 	auto b = l ? Lighted : Background;
@@ -286,9 +286,9 @@ void GameCell::update( Console &con, const bool, const uint number, const Assist
 	else
 	if ((GameCell::focused || help > Assistance::Current) && GameCell::allowed(number, help))
 	{
-		f = help >= Assistance::Sure && GameCell::cell->sure(number) ? (l ? Console::LightGreen : Console::Green) :
-		    help <= Assistance::Current                              ?      Console::Black :
-		                                                               (l ? Console::Yellow     : Console::Orange);
+		f = help >= Assistance::Sure && singles.sure(*GameCell::cell, number) ? (l ? Console::LightGreen : Console::Green) :
+		    help <= Assistance::Current                                       ?      Console::Black :
+		                                                                        (l ? Console::Yellow     : Console::Orange);
 	#if defined(UNICODE)
 		con.Put(GameCell::x, GameCell::y, L"·¹²³⁴⁵⁶⁷⁸⁹"[number]);
 	#else
@@ -297,7 +297,7 @@ void GameCell::update( Console &con, const bool, const uint number, const Assist
 	}
 	else
 	{
-		auto sure = help == Assistance::Full ? GameCell::cell->sure(number) : 0;
+		auto sure = help == Assistance::Full ? singles.sure(*GameCell::cell, number) : 0;
 		if (sure != 0)
 			f = l ? Console::LightGreen : Console::Green;
 
@@ -379,7 +379,7 @@ GameTable::GameTable( Sudoku &_s )
 	}
 }
 
-void GameTable::update( Console &con, const bool init, const uint number, const Assistance help, Cell* const focus, const bool light )
+void GameTable::update( Console &con, const bool init, const uint number, const Assistance help, Cell* const focus, const bool light, const Sudoku::Singles &singles )
 {
 	if (init)
 	{
@@ -389,7 +389,7 @@ void GameTable::update( Console &con, const bool init, const uint number, const
 	}
 
 	for (auto &c: *this)
-		c.update(con, init, number, help, focus, light);
+		c.update(con, init, number, help, focus, light, singles);
 }
 
 void GameTable::mouseMove( const int _x, const int _y )
@@ -646,12 +646,12 @@ void Game::update()
 
 	auto time = Game::timer_f ? GameTimer::now() : -1;
 	auto info = Sudoku::len() < 81 ? (Sudoku::rating == -2 ? _T("unsolvable") : Sudoku::rating == -1 ? _T("ambiguous") : _T(""))
-	                               : (Sudoku::corrupt() ? _T("corrupt") : _T("solved"));
+	                               : (Sudoku::finished() ? _T("solved") : _T("corrupt"));
 
 	Console::Fill(HDR, Console::White, colors[Sudoku::level]);
 
 	Game::hdr.update(*this, init, info, time, Sudoku::len(), Sudoku::rating);
-	Game::tab.update(*this, init, Game::number, Game::help, Game::tab.getCell(), Game::light_f);
+	Game::tab.update(*this, init, Game::number, Game::help, Game::tab.getCell(), Game::light_f, Sudoku::Singles(this));
 	Game::mnu.update(*this, init, Game::xpos);
 	Game::ftr.update(*this, init, Game::mnu.getInfo());
 
@@ -803,6 +803,18 @@ bool Game::set( uint num )
 
 void Game::command( const Command _c )
 {
+	static SudokuLatency latency[] =
+	{
+		SudokuLatency("cmd none"),
+		SudokuLatency("cmd button 0"),   SudokuLatency("cmd button 1"),   SudokuLatency("cmd button 2"),   SudokuLatency("cmd button 3"),   SudokuLatency("cmd button 4"),
+		SudokuLatency("cmd button 5"),   SudokuLatency("cmd button 6"),   SudokuLatency("cmd button 7"),   SudokuLatency("cmd button 8"),   SudokuLatency("cmd button 9"),
+		SudokuLatency("cmd clear cell"), SudokuLatency("cmd set cell"),   SudokuLatency("cmd set sure"),   SudokuLatency("cmd prev help"),  SudokuLatency("cmd next help"),
+		SudokuLatency("cmd prev level"), SudokuLatency("cmd next level"), SudokuLatency("cmd generate"),   SudokuLatency("cmd highlight"),  SudokuLatency("cmd timer"),
+		SudokuLatency("cmd solve"),      SudokuLatency("cmd undo"),       SudokuLatency("cmd clear"),      SudokuLatency("cmd edit"),       SudokuLatency("cmd accept"),
+		SudokuLatency("cmd save"),       SudokuLatency("cmd load"),       SudokuLatency("cmd quit"),
+	};
+
+	auto timer = SudokuLatency::Timer(latency[_c - NoCmd]);
 	int seconds;
 
 	switch (_c)
@@ -825,7 +837,7 @@ void Game::command( const Command _c )
 	                    break;
 	case SetCellCmd:    Game::set();
 	                    break;
-	case SetSureCmd:    Game::set(Game::tab.getCell()->sure());
+	case SetSureCmd:    Game::set(Sudoku::hint(Game::tab.getCell()));
 	                    break;
 	case PrevHelpCmd:   Game::help = (Assistance)Game::mnu[1].prev();
 	                    break;
@@ -857,6 +869,11 @@ void Game::command( const Command _c )
 	                    break;
 	case SaveCmd:       seconds = Game::timer_f ? GameTimer::now() : 0;
 	                    Sudoku::save({}, seconds);
+	                    if (SudokuLatency::enabled())
+	                    {
+	                    	auto file = std::basic_ofstream<TCHAR>(_T("sudoku.latency"));
+	                    	SudokuLatency::report(file);
+	                    }
 	                    break;
 	case LoadCmd:       if (Sudoku::load({}, &seconds))
 	                    {
@@ -872,204 +889,20 @@ void Game::command( const Command _c )
 	if (Sudoku::len() == 81)
 	{
 		Game::number = 0;
-		if (Sudoku::solved())
+		if (Sudoku::finished())
 			GameTimer::stop();
 	}
 }
 
 int _tmain( int argc, TCHAR **argv )
 {
-	int   cnt = 0;
-	TCHAR cmd = _T('g');
-	TCHAR ext = 0;
-	auto  tmp = std::basic_string<TCHAR>(*argv) + _T(".board");
-	const TCHAR *file = tmp.c_str();
-
-	if (--argc > 0 && (++argv, **argv == _T('/') || **argv == _T('-')))
-	{
-		cmd = (TCHAR)std::tolower(*++*argv);
-		if (cmd != 0)
-			ext = (TCHAR)std::tolower(*++*argv);
-	}
-
-	switch (cmd)
+	return batch(argc, argv, []
 	{
-		case _T('g'): // game
-		{
-			auto sudoku = Game();
-			LONG style = GetWindowLong(sudoku.Console::Hwnd, GWL_STYLE);
-		//	SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style & ~(WS_SIZEBOX | WS_MAXIMIZEBOX));
-			SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style & ~(WS_SIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU));
-			sudoku();
-			SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style);
-			break;
-		}
-
-		case _T('f'): // find
-		{
-			auto sudoku = Sudoku(Difficulty::Medium);
-			auto timer  = GameTimer<int>();
-			auto data   = std::vector<uint32_t>();
-
-			if (--argc > 0)
-				file = *++argv;
-
-			std::wcerr << ::title << " find" << std::endl;
-
-			GetAsyncKeyState(VK_ESCAPE);
-			while (!GetAsyncKeyState(VK_ESCAPE))
-			{
-				sudoku.generate();
-				if (ext == _T('r') || ext == _T('x'))
-					sudoku.raise(ext == _T('x'));
-				if (std::find(data.begin(), data.end(), sudoku.signature) == data.end() && sudoku.test(ext != _T('x')))
-				{
-					data.push_back(sudoku.signature);
-					std::cout << sudoku << std::endl;
-					sudoku.append(file);
-				}
-			}
-
-			std::wcerr << ::title << " find: " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
-			break;
-		}
-
-		case _T('t'): // test
-		{
-			auto sudoku = Sudoku(Difficulty::Medium);
-			auto timer  = GameTimer<int>();
-			auto data   = std::vector<uint32_t>();
-			auto coll   = std::vector<Sudoku>();
-			auto lst    = std::vector<std::basic_string<TCHAR>>();
-
-			while (--argc > 0)
-				Sudoku::load(lst, *++argv);
-			if (lst.size() == 0)
-				Sudoku::load(lst, file);
-
-			std::wcerr << ::title << " test: " << lst.size() << " boards loaded" << std::endl;
-
-			for (std::basic_string<TCHAR> &i: lst)
-			{
-				std::cerr << ' ' << ++cnt << '\r';
-				sudoku.init(i);
-				if (std::find(data.begin(), data.end(), sudoku.signature) == data.end() && sudoku.test(false))
-				{
-					data.push_back(sudoku.signature);
-					coll.emplace_back(sudoku);
-				}
-			}
-
-			std::sort(coll.begin(), coll.end(), ext == _T('w') ? Sudoku::by_weight : ext == _T('l') ? Sudoku::by_length : Sudoku::by_rating);
-
-			for (auto &tab: coll)
-				std::cout << tab << std::endl;
-
-			std::wcerr << ::title << " test: " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
-			break;
-		}
-
-		case _T('s'): // sort
-		{
-			auto sudoku = Sudoku(Difficulty::Medium);
-			auto timer  = GameTimer<int>();
-			auto data   = std::vector<uint32_t>();
-			auto coll   = std::vector<Sudoku>();
-			auto lst    = std::vector<std::basic_string<TCHAR>>();
-
-			while (--argc > 0)
-				Sudoku::load(lst, *++argv);
-			if (lst.size() == 0)
-				Sudoku::load(lst, file);
-
-			std::wcerr << ::title << " sort: " << lst.size() << " boards loaded" << std::endl;
-
-			for (std::basic_string<TCHAR> &i: lst)
-			{
-				std::cerr << ' ' << ++cnt << '\r';
-				sudoku.init(i);
-				if (std::find(data.begin(), data.end(), sudoku.signature) == data.end() && sudoku.test(true))
-				{
-					data.push_back(sudoku.signature);
-					coll.emplace_back(sudoku);
-				}
-			}
-
-			std::sort(coll.begin(), coll.end(), ext == _T('w') ? Sudoku::by_weight : ext == _T('l') ? Sudoku::by_length : Sudoku::by_rating);
-
-			for (auto &tab: coll)
-				std::cout << tab << std::endl;
-
-			std::wcerr << ::title << " sort: " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
-			break;
-		}
-
-		case _T('r'): // raise
-		{
-			auto sudoku = Sudoku(Difficulty::Medium);
-			auto timer  = GameTimer<int>();
-			auto data   = std::vector<uint32_t>();
-			auto lst    = std::vector<std::basic_string<TCHAR>>();
-
-
-			while (--argc > 0)
-				Sudoku::load(lst, *++argv);
-			if (lst.size() == 0)
-				Sudoku::load(lst, file);
-
-			std::wcerr << ::title << " raise: " << lst.size() << " boards loaded" << std::endl;
-
-			for (std::basic_string<TCHAR> &i: lst)
-			{
-				std::cerr << ' ' << ++cnt << '\r';
-				sudoku.init(i);
-				sudoku.raise(ext == _T('x'));
-				if (std::find(data.begin(), data.end(), sudoku.signature) == data.end() && sudoku.test(ext != _T('x')))
-				{
-					data.push_back(sudoku.signature);
-					std::cout << sudoku << std::endl;
-				}
-			}
-
-			std::wcerr << ::title << " raise: " << data.size() << " boards found, " << timer.now() << 's' << std::endl;
-			break;
-		}
-
-		case _T('?'): /* falls through */
-		case _T('h'): // help
-		{
-			std::cerr << "\n"
-			             "Sudoku game, solver and generator\n"
-			             "\n"
-			             "Copyright (c) 2018 - 2020 Rajmund Szymanski. All rights reserved.\n"
-			             "This software is distributed under the MIT License.\n"
-			             "You are free to modify and redistribute it.\n"
-			             "\n"
-			             "Usage:\n"
-			             "sudoku -g        - game (default)\n"
-			             "sudoku -f [file] - find (append to file)\n"
-			             "       -fr       - force raise\n"
-			             "       -fx       - force raise and show extreme only\n"
-			             "sudoku -t [file] - test for extreme (read from file)\n"
-			             "       -tw       - sort by weight/length (default is rating/length)\n"
-			             "       -tl       - sort by length/rating (default is rating/length)\n"
-			             "sudoku -s [file] - sort (read from file)\n"
-			             "       -sw       - sort by weight/length (default is rating/length)\n"
-			             "       -sl       - sort by length/rating (default is rating/length)\n"
-			             "sudoku -r [file] - raise (read from file)\n"
-			             "       -rx       - show extreme only\n"
-			             "sudoku -h        - this usage help\n"
-			             "sudoku -?        - this usage help\n"
-			          << std::endl;
-			break;
-		}
-
-		default:
-		{
-			std::wcerr << ::title << ": unknown command" << std::endl;
-			break;
-		}
-	}
-
-	return 0;
+		auto sudoku = Game();
+		LONG style = GetWindowLong(sudoku.Console::Hwnd, GWL_STYLE);
+	//	SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style & ~(WS_SIZEBOX | WS_MAXIMIZEBOX));
+		SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style & ~(WS_SIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU));
+		sudoku();
+		SetWindowLong(sudoku.Console::Hwnd, GWL_STYLE, style);
+	});
 }
@@ -137,7 +137,7 @@ public:
 
 	GameCell( const auto _x, const auto _y, Cell* const _c ): r{_x, _y, CellSize, CellSize}, cell{_c}, focused{false} {}
 
-	void    update      ( Graphics &, const uint, const Assistance, Cell* const, const bool );
+	void    update      ( Graphics &, const uint, const Assistance, Cell* const, const bool, const Sudoku::Singles & );
 	void    mouseMove   ( const int, const int );
 	void    mouseLeave  ();
 	Command mouseLButton( const int, const int, const uint, const Assistance );
@@ -153,7 +153,7 @@ public:
 
 	GameTable( Sudoku & );
 
-	void    update      ( Graphics &, const uint, const Assistance, Cell* const, const bool );
+	void    update      ( Graphics &, const uint, const Assistance, Cell* const, const bool, const Sudoku::Singles & );
 	void    mouseMove   ( const int, const int );
 	void    mouseLeave  ();
 	Command mouseLButton( const int, const int, const uint, const Assistance );
@@ -302,7 +302,7 @@ Command GameHeader::mouseLButton( const int _x, const int _y )
 
 /*---------------------------------------------------------------------------*/
 
-void GameCell::update( Graphics &gr, const uint number, const Assistance help, Cell* const focus, const bool light )
+void GameCell::update( Graphics &gr, const uint number, const Assistance help, Cell* const focus, const bool light, const Sudoku::Singles &singles )
 {
 	if (GameCell::font == nullptr)
 		GameCell::font = gr.font(CellSize, Gdiplus::FontStyle::FontStyleBold, _T("Tahoma"));
@@ -324,15 +324,15 @@ void GameCell::update( Graphics &gr, const uint number, const Assistance help, C
 	else
 	if ((GameCell::focused || help > Assistance::Current) && GameCell::allowed(number, help))
 	{
-		auto f = help >= Assistance::Sure && GameCell::cell->sure(number) ? Graphics::Color::Green :
-		         help <= Assistance::Current                              ? Graphics::Color::Gray :
-		                                                                    Graphics::Color::Orange;
+		auto f = help >= Assistance::Sure && singles.sure(*GameCell::cell, number) ? Graphics::Color::Green :
+		         help <= Assistance::Current                                       ? Graphics::Color::Gray :
+		                                                                             Graphics::Color::Orange;
 
 		gr.draw_char(GameCell::r, GameCell::tiny, f, Graphics::Alignment::Center, _T("0123456789")[number]);
 	}
 	else
 	{
-		auto sure = help == Assistance::Full ? GameCell::cell->sure(number) : 0;
+		auto sure = help == Assistance::Full ? singles.sure(*GameCell::cell, number) : 0;
 		if (sure != 0)
 			gr.draw_char(GameCell::r, GameCell::tiny, Graphics::Color::Green, Graphics::Alignment::Center, _T("0123456789")[sure]);
 	}
@@ -413,10 +413,10 @@ GameTable::GameTable( Sudoku &_s )
 	}
 }
 
-void GameTable::update( Graphics &gr, const uint number, const Assistance help, Cell* const focus, const bool light )
+void GameTable::update( Graphics &gr, const uint number, const Assistance help, Cell* const focus, const bool light, const Sudoku::Singles &singles )
 {
 	for (auto &c: *this)
-		c.update(gr, number, help, focus, light);
+		c.update(gr, number, help, focus, light, singles);
 }
 
 void GameTable::mouseMove( const int _x, const int _y )
@@ -685,7 +685,7 @@ void Game::update( HWND hWnd )
 
 	auto time = Game::timer_f ? GameTimer::now() : -1;
 	auto info = Sudoku::len() < 81 ? (Sudoku::rating == -2 ? _T("unsolvable") : Sudoku::rating == -1 ? _T("ambiguous") : nullptr)
-	                               : (Sudoku::corrupt() ? _T("corrupt") : _T("solved"));
+	                               : (Sudoku::finished() ? _T("solved") : _T("corrupt"));
 
 	RECT rc;
 	POINT cursor;
@@ -705,7 +705,7 @@ void Game::update( HWND hWnd )
 	Graphics::fill_rect(HDR, colors[Sudoku::level]);
 
 	Game::hdr.update(*this, info, time, Sudoku::len(), Sudoku::rating);
-	Game::tab.update(*this, Game::number, Game::help, Game::tab.getCell(), Game::light_f);
+	Game::tab.update(*this, Game::number, Game::help, Game::tab.getCell(), Game::light_f, Sudoku::Singles(this));
 	Game::mnu.update(*this, cursor.x);
 	Game::ftr.update(*this, mnu.getInfo());
 
@@ -810,6 +810,18 @@ bool Game::set( uint num )
 
 void Game::command( const Command _c )
 {
+	static SudokuLatency latency[] =
+	{
+		SudokuLatency("cmd none"),
+		SudokuLatency("cmd button 0"),   SudokuLatency("cmd button 1"),   SudokuLatency("cmd button 2"),   SudokuLatency("cmd button 3"),   SudokuLatency("cmd button 4"),
+		SudokuLatency("cmd button 5"),   SudokuLatency("cmd button 6"),   SudokuLatency("cmd button 7"),   SudokuLatency("cmd button 8"),   SudokuLatency("cmd button 9"),
+		SudokuLatency("cmd clear cell"), SudokuLatency("cmd set cell"),   SudokuLatency("cmd set sure"),   SudokuLatency("cmd prev help"),  SudokuLatency("cmd next help"),
+		SudokuLatency("cmd prev level"), SudokuLatency("cmd next level"), SudokuLatency("cmd generate"),   SudokuLatency("cmd highlight"),  SudokuLatency("cmd timer"),
+		SudokuLatency("cmd solve"),      SudokuLatency("cmd undo"),       SudokuLatency("cmd clear"),      SudokuLatency("cmd edit"),       SudokuLatency("cmd accept"),
+		SudokuLatency("cmd save"),       SudokuLatency("cmd load"),       SudokuLatency("cmd quit"),
+	};
+
+	auto timer = SudokuLatency::Timer(latency[_c - NoCmd]);
 	int seconds;
 
 	switch (_c)
@@ -832,7 +844,7 @@ void Game::command( const Command _c )
 	                    break;
 	case SetCellCmd:    Game::set();
 	                    break;
-	case SetSureCmd:    Game::set(Game::tab.getCell()->sure());
+	case SetSureCmd:    Game::set(Sudoku::hint(Game::tab.getCell()));
 	                    break;
 	case PrevHelpCmd:   Game::help = (Assistance)Game::mnu[1].prev();
 	                    break;
@@ -864,6 +876,11 @@ void Game::command( const Command _c )
 	                    break;
 	case SaveCmd:       seconds = Game::timer_f ? GameTimer::now() : 0;
 	                    Sudoku::save({}, seconds);
+	                    if (SudokuLatency::enabled())
+	                    {
+	                    	auto file = std::basic_ofstream<TCHAR>(_T("sudoku.latency"));
+	                    	SudokuLatency::report(file);
+	                    }
 	                    break;
 	case LoadCmd:       if (Sudoku::load({}, &seconds))
 	                    {
@@ -879,7 +896,7 @@ void Game::command( const Command _c )
 	if (Sudoku::len() == 81)
 	{
 		Game::number = 0;
-		if (Sudoku::solved())
+		if (Sudoku::finished())
 			GameTimer::stop();
 	}
 }
@@ -914,8 +931,11 @@ LRESULT CALLBACK WndProc( HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam )
 }
 
 //----------------------------------------------------------------------------
-int WINAPI _tWinMain( HINSTANCE hInstance, HINSTANCE, LPTSTR, int nCmdShow )
+int WINAPI _tWinMain( HINSTANCE hInstance, HINSTANCE, LPTSTR lpCmdLine, int nCmdShow )
 {
+	if (_tcsstr(lpCmdLine, _T("--latency")) != nullptr)
+		SudokuLatency::enable();
+
 	WNDCLASSEX wc = {};
 	wc.cbSize        = sizeof(wc);
 	wc.style         = CS_HREDRAW | CS_VREDRAW;
@@ -960,5 +980,11 @@ int WINAPI _tWinMain( HINSTANCE hInstance, HINSTANCE, LPTSTR, int nCmdShow )
 		game.update(hWnd);
 	}
 
+	if (SudokuLatency::enabled())
+	{
+		auto file = std::basic_ofstream<TCHAR>(_T("sudoku.latency"));
+		SudokuLatency::report(file);
+	}
+
 	return 0;
 }
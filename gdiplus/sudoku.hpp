@@ -31,17 +31,40 @@
 
 #pragma once
 
+#include <cstdint>
+#include <climits>
 #include <list>
 #include <array>
 #include <tuple>
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <numeric>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <random>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <charconv>
+#include <bit>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <bitset>
+#include <cstdlib>
+#include <csignal>
+#if defined(_WIN32)
 #include <tchar.h>
+#else
+typedef char TCHAR;	// char-based text on systems without <tchar.h>
+#if !defined(_T)
+#define _T(x) x
+#endif
+#endif
 
 class SudokuCell;
 class Sudoku;
@@ -50,7 +73,7 @@ using cell_ref = std::reference_wrapper<SudokuCell>;
 using cell_array = std::array<SudokuCell, 81>;
 using uint = unsigned int;
 
-static inline auto gen = std::mt19937{std::random_device{}()};
+static thread_local auto gen = std::mt19937{std::random_device{}()};
 
 static inline uint random( uint size )
 {
@@ -74,6 +97,607 @@ enum class Force
 	Safe,
 };
 
+class SudokuCache
+{
+public:
+
+	virtual ~SudokuCache() = default;
+
+	virtual bool find ( uint64_t key, int &rating, Difficulty &level, uint32_t &signature ) = 0;
+	virtual void store( uint64_t key, int  rating, Difficulty  level, uint32_t  signature ) = 0;
+};
+
+// limits of the time and the number of layouts verified by Sudoku::raise
+struct SudokuBudget
+{
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	size_t                                nodes    = SIZE_MAX;
+	const volatile std::sig_atomic_t     *stop     = nullptr;	// set asynchronously, e.g. by a signal handler
+
+	bool spend()
+	{
+		if (nodes == 0 || (stop != nullptr && *stop != 0) || std::chrono::steady_clock::now() >= deadline)
+			return false;
+		nodes--;
+		return true;
+	}
+};
+
+struct SudokuRecord
+{
+	std::array<char, 81> cells;	// as in the board file: '.' - empty, '1'..'9' - immutable, 'A'..'I' - entered
+	Difficulty           level;
+	uint                 length;
+	int                  rating;
+	uint32_t             signature;
+	int                  duration;
+
+	// one line of the board file: 81 cells and optional "|level:length:rating:signature:duration"
+	bool parse( const char *first, const char *last )
+	{
+		if (first != last && last[-1] == '\r')
+			--last;
+		if (first == last)
+			return false;
+
+		auto n = std::min<size_t>(SudokuRecord::cells.size(), static_cast<size_t>(last - first));
+		std::fill(std::copy_n(first, n, SudokuRecord::cells.begin()), SudokuRecord::cells.end(), '.');
+
+		SudokuRecord::level     = Difficulty::Medium;
+		SudokuRecord::length    = 0;
+		SudokuRecord::rating    = 0;
+		SudokuRecord::signature = 0;
+		SudokuRecord::duration  = 0;
+
+		const char *p = first + n;
+		auto field = [&p, last]( auto &value, int base = 10 )
+		{
+			if (p == last || (*p != '|' && *p != ':'))
+				return false;
+			for (++p; p != last && *p == ' '; ++p);
+			auto [ptr, ec] = std::from_chars(p, last, value, base);
+			p = ptr;
+			return ec == std::errc();
+		};
+
+		int l = 0;
+		if (!field(l))
+			return true;
+
+		SudokuRecord::level = (l > Difficulty::Any && l <= Difficulty::Extreme) ? static_cast<Difficulty>(l) : Difficulty::Medium;
+		if (field(SudokuRecord::length) && field(SudokuRecord::rating) && field(SudokuRecord::signature, 16))
+			field(SudokuRecord::duration);
+
+		return true;
+	}
+
+	int weight() const
+	{
+		return SudokuRecord::rating - static_cast<int>(SudokuRecord::length) * 25;
+	}
+
+	// packed sort keys, the smaller key goes first:
+	// value (descending, 16 bits), length (7 bits), level (descending, 3 bits), signature (32 bits)
+	static
+	uint64_t key( const int value, const uint length, const Difficulty level, const uint32_t signature )
+	{
+		auto v = static_cast<uint64_t>(INT16_MAX - std::clamp<int>(value, INT16_MIN, INT16_MAX));
+		auto l = static_cast<uint64_t>(std::min<uint>(length, 127));
+		auto d = static_cast<uint64_t>(7 - level);
+		return v << 42 | l << 35 | d << 32 | signature;
+	}
+
+	static
+	uint64_t by_weight( const SudokuRecord &rec )
+	{
+		return SudokuRecord::key(rec.weight(), rec.length, rec.level, rec.signature);
+	}
+
+	static
+	uint64_t by_rating( const SudokuRecord &rec )
+	{
+		return SudokuRecord::key(rec.rating, rec.length, rec.level, rec.signature);
+	}
+
+	static
+	uint64_t by_length( const SudokuRecord &rec )
+	{
+		auto v = static_cast<uint64_t>(std::min<uint>(rec.length, 127));
+		auto r = static_cast<uint64_t>(INT16_MAX - std::clamp<int>(rec.rating, INT16_MIN, INT16_MAX));
+		auto d = static_cast<uint64_t>(7 - rec.level);
+		return v << 51 | r << 35 | d << 32 | rec.signature;
+	}
+
+	template<class T> friend
+	std::basic_ostream<T> &operator <<( std::basic_ostream<T> &out, const SudokuRecord &rec )
+	{
+		for (char c: rec.cells)
+			out << c;
+		out << '|'          <<             rec.level     << ':'
+		    << std::setw(2) <<             rec.length    << ':'
+		    << std::setw(3) <<             rec.rating    << ':'
+		    << std::setw(8) << std::hex << rec.signature << ':'
+		    << std::setw(0) << std::dec << rec.duration;
+		return out;
+	}
+};
+
+// search effort counters, compiled in with SUDOKU_STATS; every thread counts separately
+struct SudokuStats: public std::array<uint64_t, 13>
+{
+	enum Counter
+	{
+		SolveNodes,
+		SolveBacktracks,
+		Allowed,
+		Sure,
+		Len,
+		Range,
+		RatingNodes,
+		Uniqueness,
+		RaiseTried,
+		RaiseAccepted,
+		RejectUnsolvable,
+		RejectAmbiguous,
+		RejectLevel,
+	};
+
+	static constexpr const char *names[] = { "solve", "backtrack", "allowed", "sure", "len", "range", "rating",
+	                                         "unique", "tried", "accepted", "unsolvable", "ambiguous", "level" };
+
+	SudokuStats(): std::array<uint64_t, 13>{} {}
+
+	SudokuStats &operator +=( const SudokuStats &s )
+	{
+		for (size_t i = 0; i < s.size(); i++)
+			SudokuStats::at(i) += s[i];
+		return *this;
+	}
+
+	SudokuStats operator -( const SudokuStats &s ) const
+	{
+		SudokuStats result;
+		for (size_t i = 0; i < s.size(); i++)
+			result[i] = SudokuStats::at(i) - s[i];
+		return result;
+	}
+
+	// counters of the calling thread; added to the totals when the thread exits
+	static SudokuStats &local()
+	{
+		struct Local: SudokuStats
+		{
+			~Local()
+			{
+				auto guard = std::lock_guard(SudokuStats::lock());
+				SudokuStats::totals() += *this;
+			}
+		};
+
+		static thread_local Local stats;
+		return stats;
+	}
+
+	// counters of the finished threads and the calling thread
+	static SudokuStats total()
+	{
+		auto guard = std::lock_guard(SudokuStats::lock());
+		SudokuStats result = SudokuStats::totals();
+		return result += SudokuStats::local();
+	}
+
+	template<class T> friend
+	std::basic_ostream<T> &operator <<( std::basic_ostream<T> &out, const SudokuStats &stats )
+	{
+		for (size_t i = 0; i < stats.size(); i++)
+			out << (i > 0 ? " " : "") << SudokuStats::names[i] << '=' << stats[i];
+		return out;
+	}
+
+private:
+
+	static std::mutex &lock()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static SudokuStats &totals()
+	{
+		static SudokuStats stats;
+		return stats;
+	}
+};
+
+// heap allocations per engine phase, recorded by the global operator new of the builds with SUDOKU_ALLOCS
+struct SudokuAllocs
+{
+	enum Phase: uint8_t
+	{
+		Other,
+		Construct,
+		Init,
+		Set,
+		Solve,
+		Generate,
+		Accept,
+		Rating,
+		Level,
+		Signature,
+		Raise,
+		Count
+	};
+
+	static constexpr const char *names[] = { "other", "construct", "init", "set", "solve", "generate",
+	                                         "accept", "rating", "level", "signature", "raise" };
+
+	std::array<uint64_t, Count> count{};
+	std::array<uint64_t, Count> bytes{};
+
+	SudokuAllocs operator -( const SudokuAllocs &a ) const
+	{
+		SudokuAllocs result;
+		for (size_t i = 0; i < Count; i++)
+		{
+			result.count[i] = SudokuAllocs::count[i] - a.count[i];
+			result.bytes[i] = SudokuAllocs::bytes[i] - a.bytes[i];
+		}
+		return result;
+	}
+
+	uint64_t allocations() const
+	{
+		return std::accumulate(SudokuAllocs::count.begin(), SudokuAllocs::count.end(), uint64_t(0));
+	}
+
+	// the phase of the calling thread for the duration of the scope
+	class Scope
+	{
+		Phase prev_;
+
+	public:
+
+		explicit Scope( const Phase phase ): prev_{phase_} { phase_ = phase; }
+		~Scope() { phase_ = prev_; }
+
+		Scope( const Scope & ) = delete;
+		Scope &operator=( const Scope & ) = delete;
+	};
+
+	// called from the operator new; must not allocate
+	static void record( const size_t size )
+	{
+		SudokuAllocs &local = SudokuAllocs::local();
+		local.count[phase_]++;
+		local.bytes[phase_] += size;
+		totals_[phase_].fetch_add(1, std::memory_order_relaxed);
+		totals_[Count + phase_].fetch_add(size, std::memory_order_relaxed);
+	}
+
+	// allocations of the calling thread
+	static SudokuAllocs &local()
+	{
+		static thread_local SudokuAllocs allocs;
+		return allocs;
+	}
+
+	// allocations of all threads
+	static SudokuAllocs total()
+	{
+		SudokuAllocs result;
+		for (size_t i = 0; i < Count; i++)
+		{
+			result.count[i] = totals_[i].load(std::memory_order_relaxed);
+			result.bytes[i] = totals_[Count + i].load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	template<class T> friend
+	std::basic_ostream<T> &operator <<( std::basic_ostream<T> &out, const SudokuAllocs &allocs )
+	{
+		out << "allocs=" << allocs.allocations();
+		for (size_t i = 0; i < Count; i++)
+			if (allocs.count[i] > 0)
+				out << ' ' << SudokuAllocs::names[i] << '=' << allocs.count[i] << '/' << allocs.bytes[i] << 'B';
+		return out;
+	}
+
+private:
+
+	static inline thread_local Phase phase_ = Other;
+	static inline std::array<std::atomic<uint64_t>, 2 * Count> totals_{};
+};
+
+#if defined(SUDOKU_ALLOCS)
+#define SUDOKU_PHASE(phase) auto alloc_scope = SudokuAllocs::Scope(SudokuAllocs::phase)
+#else
+#define SUDOKU_PHASE(phase) ((void) 0)
+#endif
+
+// scoped trace spans, recorded (in a ring buffer of every thread) only while enabled
+class SudokuTrace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Event
+	{
+		const char *name;
+		int64_t     start;	// nanoseconds since the epoch of the trace
+		int64_t     duration;
+	};
+
+	struct Buffer
+	{
+		std::vector<Event> events;
+		size_t             count;	// number of events ever recorded
+		uint               tid;
+	};
+
+	static inline std::atomic<bool> enabled_ = false;
+	static inline Clock::time_point epoch_   = Clock::now();
+
+	static std::mutex &lock()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::vector<std::shared_ptr<Buffer>> &buffers()
+	{
+		static std::vector<std::shared_ptr<Buffer>> list;
+		return list;
+	}
+
+	static Buffer &local()
+	{
+		static thread_local std::shared_ptr<Buffer> buffer = []
+		{
+			auto guard = std::lock_guard(SudokuTrace::lock());
+			auto &list = SudokuTrace::buffers();
+			auto result = std::make_shared<Buffer>(Buffer{ std::vector<Event>(SudokuTrace::capacity), 0, static_cast<uint>(list.size() + 1) });
+			list.push_back(result);
+			return result;
+		}();
+		return *buffer;
+	}
+
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count();
+	}
+
+public:
+
+	static constexpr size_t capacity = 1 << 16;
+
+	class Span
+	{
+		const char *name_;
+		int64_t     start_;
+
+	public:
+
+		explicit Span( const char *name ): name_{enabled_.load(std::memory_order_relaxed) ? name : nullptr}, start_{name_ != nullptr ? SudokuTrace::now() : 0} {}
+
+		~Span()
+		{
+			if (name_ == nullptr)
+				return;
+
+			Buffer &b = SudokuTrace::local();
+			b.events[b.count++ % SudokuTrace::capacity] = { name_, start_, SudokuTrace::now() - start_ };
+		}
+
+		Span( const Span & ) = delete;
+		Span &operator=( const Span & ) = delete;
+	};
+
+	static void enable( bool on = true )
+	{
+		enabled_ = on;
+	}
+
+	// Chrome / Perfetto trace format; the recording threads must have finished (or be idle)
+	template<class T>
+	static void dump( std::basic_ostream<T> &out )
+	{
+		// microseconds with three decimal places
+		auto us = [&out]( const int64_t ns )
+		{
+			out << ns / 1000 << '.' << static_cast<char>('0' + ns / 100 % 10) << static_cast<char>('0' + ns / 10 % 10) << static_cast<char>('0' + ns % 10);
+		};
+
+		auto guard = std::lock_guard(SudokuTrace::lock());
+		const char *sep = "";
+		out << "{\"traceEvents\":[";
+		for (auto &b: SudokuTrace::buffers())
+		{
+			size_t first = b->count > SudokuTrace::capacity ? b->count - SudokuTrace::capacity : 0;
+			for (size_t i = first; i < b->count; i++)
+			{
+				const Event &e = b->events[i % SudokuTrace::capacity];
+				out << sep << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":";
+				us(e.start);
+				out << ",\"dur\":";
+				us(e.duration);
+				out << '}';
+				sep = ",";
+			}
+		}
+		out << "\n]}" << std::endl;
+	}
+};
+
+// latency histograms (HDR-style: every power of two of nanoseconds is divided into 32 linear
+// sub-ranges, so the reported percentiles are within 1/32 of the measured values)
+class SudokuLatency
+{
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr uint   bits    = 5;
+	static constexpr size_t half    = size_t(1) << bits;
+	static constexpr size_t buckets = (64 - bits + 1) * half;
+
+	const char *name_;
+	std::array<std::atomic<uint64_t>, buckets> counts_;
+	std::atomic<uint64_t> count_;
+	std::atomic<uint64_t> max_;
+
+	static inline std::atomic<bool> enabled_ = false;
+
+	static std::mutex &lock()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::vector<SudokuLatency *> &histograms()
+	{
+		static std::vector<SudokuLatency *> list;
+		return list;
+	}
+
+	static size_t index_( const uint64_t ns )
+	{
+		if (ns < 2 * half)
+			return static_cast<size_t>(ns);
+		uint shift = static_cast<uint>(std::bit_width(ns)) - bits - 1;
+		return shift * half + static_cast<size_t>(ns >> shift);
+	}
+
+	// the highest value counted in the bucket
+	static uint64_t value_( const size_t index )
+	{
+		if (index < 2 * half)
+			return index;
+		uint shift = static_cast<uint>(index / half) - 1;
+		return ((static_cast<uint64_t>(index - shift * half) + 1) << shift) - 1;
+	}
+
+	static std::string text_( const uint64_t ns )
+	{
+		static constexpr std::pair<uint64_t, const char *> units[] = { { 1000000000, "s" }, { 1000000, "ms" }, { 1000, "us" } };
+
+		for (auto [unit, name]: units)
+			if (ns >= unit)
+				return std::to_string(ns / unit) + '.' + static_cast<char>('0' + ns * 10 / unit % 10) + name;
+		return std::to_string(ns) + "ns";
+	}
+
+public:
+
+	explicit SudokuLatency( const char *name ): name_{name}, counts_{}, count_{0}, max_{0}
+	{
+		auto guard = std::lock_guard(SudokuLatency::lock());
+		SudokuLatency::histograms().push_back(this);
+	}
+
+	~SudokuLatency()
+	{
+		auto guard = std::lock_guard(SudokuLatency::lock());
+		std::erase(SudokuLatency::histograms(), this);
+	}
+
+	SudokuLatency( const SudokuLatency & ) = delete;
+	SudokuLatency &operator=( const SudokuLatency & ) = delete;
+
+	// records the lifetime of the timer, only while enabled
+	class Timer
+	{
+		SudokuLatency     *histogram_;
+		Clock::time_point  start_;
+
+	public:
+
+		explicit Timer( SudokuLatency &histogram ): histogram_{enabled_.load(std::memory_order_relaxed) ? &histogram : nullptr}, start_{histogram_ != nullptr ? Clock::now() : Clock::time_point{}} {}
+
+		~Timer()
+		{
+			if (histogram_ != nullptr)
+				histogram_->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count()));
+		}
+
+		Timer( const Timer & ) = delete;
+		Timer &operator=( const Timer & ) = delete;
+	};
+
+	static void enable( bool on = true )
+	{
+		enabled_ = on;
+	}
+
+	static bool enabled()
+	{
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	void record( const uint64_t ns )
+	{
+		SudokuLatency::counts_[SudokuLatency::index_(ns)].fetch_add(1, std::memory_order_relaxed);
+		SudokuLatency::count_.fetch_add(1, std::memory_order_relaxed);
+		uint64_t max = SudokuLatency::max_.load(std::memory_order_relaxed);
+		while (ns > max && !SudokuLatency::max_.compare_exchange_weak(max, ns, std::memory_order_relaxed));
+	}
+
+	uint64_t count() const
+	{
+		return SudokuLatency::count_.load(std::memory_order_relaxed);
+	}
+
+	uint64_t max() const
+	{
+		return SudokuLatency::max_.load(std::memory_order_relaxed);
+	}
+
+	// the smallest recorded latency not exceeded by the given fraction of the records
+	uint64_t percentile( const double fraction ) const
+	{
+		uint64_t total = 0;
+		for (auto &c: SudokuLatency::counts_)
+			total += c.load(std::memory_order_relaxed);
+
+		uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))), 1);
+		uint64_t seen = 0;
+		for (size_t i = 0; i < buckets; i++)
+			if ((seen += SudokuLatency::counts_[i].load(std::memory_order_relaxed)) >= target)
+				return std::min(SudokuLatency::value_(i), SudokuLatency::max());
+		return SudokuLatency::max();
+	}
+
+	// table of the histograms with any records; may be called at any time
+	template<class T>
+	static void report( std::basic_ostream<T> &out )
+	{
+		static constexpr std::pair<double, const char *> points[] = { { .5, "p50" }, { .9, "p90" }, { .99, "p99" }, { .999, "p99.9" } };
+
+		auto guard = std::lock_guard(SudokuLatency::lock());
+		auto list = SudokuLatency::histograms();
+		std::ranges::sort(list, []( const SudokuLatency *a, const SudokuLatency *b ){ return std::string_view(a->name_) < b->name_; });
+
+		out << std::left << std::setw(16) << "latency" << std::right << std::setw(10) << "count";
+		for (auto [fraction, name]: points)
+			out << std::setw(10) << name;
+		out << std::setw(10) << "max" << std::endl;
+
+		for (const SudokuLatency *h: list)
+		{
+			if (h->count() == 0)
+				continue;
+			out << std::left << std::setw(16) << h->name_ << std::right << std::setw(10) << h->count();
+			for (auto [fraction, name]: points)
+				out << std::setw(10) << SudokuLatency::text_(h->percentile(fraction)).c_str();
+			out << std::setw(10) << SudokuLatency::text_(h->max()).c_str() << std::endl;
+		}
+	}
+};
+
+#if defined(SUDOKU_STATS)
+#define SUDOKU_COUNT(counter) (SudokuStats::local()[SudokuStats::counter]++)
+#else
+#define SUDOKU_COUNT(counter) ((void) 0)
+#endif
+
 class SudokuCell
 {
 	using Cell = SudokuCell;
@@ -187,6 +811,7 @@ public:
 
 	uint len()
 	{
+		SUDOKU_COUNT(Len);
 		if (Cell::num != 0)
 			return 0;
 
@@ -195,6 +820,7 @@ public:
 
 	uint range()
 	{
+		SUDOKU_COUNT(Range);
 		return std::accumulate(std::begin(Cell::lst), std::end(Cell::lst), (uint)0, []( uint r, Cell &c ){ return r + c.len(); });
 	}
 
@@ -238,6 +864,7 @@ public:
 
 	bool allowed( uint n )
 	{
+		SUDOKU_COUNT(Allowed);
 		if (Cell::num != 0 || n == 0)
 			return false;
 
@@ -255,6 +882,7 @@ public:
 
 	uint sure( uint n = 0 )
 	{
+		SUDOKU_COUNT(Sure);
 		if (Cell::num == 0 && n == 0)
 		{
 			for (uint v: Cell::Values(*this))
@@ -291,6 +919,7 @@ public:
 
 	bool solve( bool check = false )
 	{
+		SUDOKU_COUNT(SolveNodes);
 		cell_ref c = *std::ranges::min_element(Cell::lst, Cell::by_length);
 		if (c.get().num != 0)
 		{
@@ -308,153 +937,444 @@ public:
 				if (check)
 					cell.num = 0;
 
-				return true;
+				return true;
+			}
+		}
+
+		cell.num = 0;
+		SUDOKU_COUNT(SolveBacktracks);
+		return false;
+	}
+
+	bool generate( Difficulty level, bool check = false )
+	{
+		if (Cell::num == 0 || Cell::immutable)
+			return false;
+
+		uint n = Cell::num;
+
+		Cell::num = 0;
+		if (Cell::sure(n))
+			return true;
+
+		Cell::num = n;
+		if (level == Difficulty::Easy && !check)
+			return false;
+
+		for (uint v: Cell::Values(*this))
+		{
+			if (v != 0)
+				SUDOKU_COUNT(Uniqueness);
+			if ((Cell::num = v) != 0 && Cell::solve(true))
+			{
+				Cell::num = n;
+				return false;
+			}
+		}
+
+		Cell::num = 0;
+		return true;
+	}
+
+	static
+	bool by_length( Cell &a, Cell &b )
+	{
+		uint a_len = a.len();
+		uint b_len = b.len();
+
+		return a.num == 0 &&
+		      (b.num != 0 || a_len <  b_len ||
+		                    (a_len == b_len && a.range() < b.range()));
+	}
+
+	static
+	bool by_solid( Cell &a, Cell &b )
+	{
+		return a.solid() > b.solid();
+	}
+
+	template<class T> friend
+	std::basic_ostream<T> &operator <<( std::basic_ostream<T> &out, const Cell &cell )
+	{
+		out << (cell.immutable ? ".123456789" : ".ABCDEFGHI")[cell.num];
+
+		return out;
+	}
+};
+
+class Sudoku: public cell_array
+{
+	using Cell = SudokuCell;
+
+	friend class SudokuBench;
+
+	static const
+	std::vector<std::basic_string<TCHAR>> extreme;
+
+	static const
+	std::basic_string<TCHAR> html;
+
+	std::list<std::pair<Cell *, uint>> mem;
+
+	// values and immutable flags of all cells, one byte per cell
+	class Snapshot: public std::array<uint8_t, 81>
+	{
+		static constexpr uint8_t value = 0x0F;
+		static constexpr uint8_t fixed = 0x10;
+
+		cell_array *tab_;
+
+	public:
+
+		Snapshot( cell_array *tab ): tab_{tab}
+		{
+			Snapshot::reload();
+		}
+
+		void reload()
+		{
+			for (Cell &c: *tab_)
+				Snapshot::at(c.pos) = static_cast<uint8_t>(c.num | (c.immutable ? fixed : 0));
+		}
+
+		void restore()
+		{
+			for (Cell &c: *tab_)
+			{
+				c.num = Snapshot::at(c.pos) & value;
+				c.immutable = (Snapshot::at(c.pos) & fixed) != 0;
+			}
+		}
+
+		bool changed()
+		{
+			return std::ranges::any_of(*tab_, [this]( Cell &c ){ return c.num != (Snapshot::at(c.pos) & value); });
+		}
+
+		// sets the saved values again, one by one, checking the rules
+		bool reset()
+		{
+			return std::ranges::all_of(*tab_, [this]( Cell &c ){ return c.set(Snapshot::at(c.pos) & value); });
+		}
+	};
+
+	// snapshot restored at the end of the scope
+	class Temp: public Sudoku::Snapshot
+	{
+	public:
+
+		Temp( cell_array *tab ): Sudoku::Snapshot(tab) {}
+		~Temp() { Sudoku::Snapshot::restore(); }
+
+		Temp( const Temp & ) = delete;
+		Temp &operator=( const Temp & ) = delete;
+	};
+
+	// log of the speculative changes of the cells (position, previous value); the changes made
+	// after a mark are rolled back in the reverse order, in the time proportional to their number
+	class Trail
+	{
+		struct Entry
+		{
+			uint8_t pos;
+			uint8_t num;
+		};
+
+		// every cell is emptied or filled at most once along a path of the search
+		std::array<Entry, 2 * 81> log_;
+		size_t                    size_;
+		cell_array               *tab_;
+
+		void push_( const Cell &cell, uint num )
+		{
+			if (size_ >= log_.size())	// a broken bound of log_ must not corrupt the memory, even with NDEBUG
+				std::abort();
+			log_[size_++] = { static_cast<uint8_t>(cell.pos), static_cast<uint8_t>(num) };
+		}
+
+	public:
+
+		Trail( cell_array *tab ): log_{}, size_{0}, tab_{tab} {}
+
+		size_t mark() const
+		{
+			return size_;
+		}
+
+		void assign( Cell &cell, uint n )
+		{
+			Trail::push_(cell, cell.num);
+			cell.num = n;
+		}
+
+		bool set( Cell &cell, uint n )
+		{
+			uint t = cell.num;
+			if (!cell.set(n))
+				return false;
+			Trail::push_(cell, t);
+			return true;
+		}
+
+		void rollback( const size_t mark )
+		{
+			while (size_ > mark)
+			{
+				const Entry &e = log_[--size_];
+				(*tab_)[e.pos].num = e.num;
+			}
+		}
+
+		// the changes made after the mark stay
+		void keep( const size_t mark )
+		{
+			size_ = mark;
+		}
+	};
+
+	// positions of the 20 peers of every cell: the same row, column and segment
+	using Peers = std::array<std::array<uint8_t, 20>, 81>;
+
+	static constexpr Peers peers_ = []
+	{
+		Peers result{};
+		for (uint p = 0; p < 81; p++)
+		{
+			size_t n = 0;
+			for (uint q = 0; q < 81; q++)
+				if (q != p && (q / 9 == p / 9 || q % 9 == p % 9 || (q / 27 == p / 27 && q % 9 / 3 == p % 9 / 3)))
+					result[p][n++] = static_cast<uint8_t>(q);
+		}
+		return result;
+	}();
+
+	// facts about one layout shared by the rating, the level and the signature: the candidates of
+	// the cells from the bit masks of the units, the ranges on the first use only, and the solution
+	// found by correct()
+	class Analysis
+	{
+		std::array<uint8_t, 81> len_;
+		std::array<uint8_t, 81> range_;
+		bool                    ranged_;
+		bool                    solved_;
+
+	public:
+
+		std::array<uint8_t, 81> solution;	// valid if correct() returned 0 or -1
+		int                     status;	// result of correct(); 1 until it is known
+
+		Analysis( cell_array *tab ): len_{}, range_{}, ranged_{false}, solved_{true}, solution{}, status{1}
+		{
+			std::array<uint16_t, 27> seen{};
+			uint16_t twice = 0;
+			for (Cell &c: *tab)
+			{
+				if (c.num == 0)
+				{
+					solved_ = false;
+					continue;
+				}
+				auto bit = static_cast<uint16_t>(1U << c.num);
+				for (size_t u: { c.pos / 9, 9 + c.pos % 9, 18 + c.pos / 27 * 3 + c.pos % 9 / 3 })
+				{
+					twice = static_cast<uint16_t>(twice | (seen[u] & bit));
+					seen[u] = static_cast<uint16_t>(seen[u] | bit);
+				}
+			}
+
+			solved_ = solved_ && twice == 0;
+			for (Cell &c: *tab)
+			{
+				if (c.num != 0)
+					continue;
+				auto used = seen[c.pos / 9] | seen[9 + c.pos % 9] | seen[18 + c.pos / 27 * 3 + c.pos % 9 / 3];
+				len_[c.pos] = static_cast<uint8_t>(std::popcount(static_cast<uint16_t>(~used & 0x3FE)));
 			}
 		}
 
-		cell.num = 0;
-		return false;
-	}
-
-	bool generate( Difficulty level, bool check = false )
-	{
-		if (Cell::num == 0 || Cell::immutable)
-			return false;
-
-		uint n = Cell::num;
-
-		Cell::num = 0;
-		if (Cell::sure(n))
-			return true;
-
-		Cell::num = n;
-		if (level == Difficulty::Easy && !check)
-			return false;
+		// the same as Cell::len() and Cell::range() of the layout
+		uint len( const Cell &c ) const
+		{
+			return len_[c.pos];
+		}
 
-		for (uint v: Cell::Values(*this))
+		uint range( const Cell &c )
 		{
-			if ((Cell::num = v) != 0 && Cell::solve(true))
+			if (!ranged_)
 			{
-				Cell::num = n;
-				return false;
+				for (uint p = 0; p < 81; p++)
+				{
+					uint r = 0;
+					for (uint8_t q: peers_[p])
+						r += len_[q];
+					range_[p] = static_cast<uint8_t>(r);
+				}
+				ranged_ = true;
 			}
+			return range_[c.pos];
 		}
 
-		Cell::num = 0;
-		return true;
-	}
+		// the same as Sudoku::solved() of the layout
+		bool solved() const
+		{
+			return solved_;
+		}
+	};
 
-	static
-	bool by_length( Cell &a, Cell &b )
-	{
-		uint a_len = a.len();
-		uint b_len = b.len();
+	Sudoku::Trail trail;
 
-		return a.num == 0 &&
-		      (b.num != 0 || a_len <  b_len ||
-		                    (a_len == b_len && a.range() < b.range()));
-	}
+public:
 
-	static
-	bool by_solid( Cell &a, Cell &b )
+	// the digits that are sure for all the empty cells at once, the same as Cell::sure() of every cell:
+	// the only candidate of the cell, or the only place of the digit in a row, column or segment;
+	// counted with the bit masks of the units ('once' / 'more' than once) instead of the search of the peers
+	class Singles
 	{
-		return a.solid() > b.solid();
-	}
+		struct Single
+		{
+			Cell *cell;
+			uint  num;
+		};
 
-	template<class T> friend
-	std::basic_ostream<T> &operator <<( std::basic_ostream<T> &out, const Cell &cell )
-	{
-		out << (cell.immutable ? ".123456789" : ".ABCDEFGHI")[cell.num];
+		std::array<uint16_t, 81> sure_;
+		std::array<Single, 81>   list_;
+		size_t                   size_;
+		bool                     stuck_;
 
-		return out;
-	}
-};
+		static std::array<size_t, 3> units_( const size_t p )
+		{
+			return { p / 9, 9 + p % 9, 18 + p / 27 * 3 + p % 9 / 3 };
+		}
 
-class Sudoku: public cell_array
-{
-	using Cell = SudokuCell;
+	public:
 
-	static const
-	std::vector<std::basic_string<TCHAR>> extreme;
+		Singles( cell_array *tab ): sure_{}, list_{}, size_{0}, stuck_{false}
+		{
+			// the digits of the units and the repeated ones
+			std::array<uint16_t, 27> seen{};
+			std::array<uint16_t, 27> twice{};
+			for (Cell &c: *tab)
+			{
+				if (c.num == 0)
+					continue;
+				auto bit = static_cast<uint16_t>(1U << c.num);
+				for (size_t u: units_(c.pos))
+				{
+					twice[u] = static_cast<uint16_t>(twice[u] | (seen[u] & bit));
+					seen[u]  = static_cast<uint16_t>(seen[u] | bit);
+				}
+			}
 
-	static const
-	std::basic_string<TCHAR> html;
+			// the candidates of the empty cells (Cell::len) and the corrupt digits
+			std::array<uint16_t, 81> cand{};
+			std::bitset<81>          dup;
+			for (Cell &c: *tab)
+			{
+				auto [r, k, s] = units_(c.pos);
+				if (c.num == 0)
+					cand[c.pos] = static_cast<uint16_t>(~(seen[r] | seen[k] | seen[s]) & 0x3FE);
+				else
+					dup[c.pos] = ((twice[r] | twice[k] | twice[s]) & (1U << c.num)) != 0;
+			}
 
-	std::list<std::pair<Cell *, uint>> mem;
+			// the allowed digits (Cell::allowed): no peer may become corrupt
+			std::array<uint16_t, 81> allowed{};
+			std::array<uint16_t, 27> once{};
+			std::array<uint16_t, 27> more{};
+			for (Cell &c: *tab)
+			{
+				if (c.num != 0)
+					continue;
+				uint16_t mask = cand[c.pos];
+				for (uint8_t q: peers_[c.pos])
+				{
+					if ((*tab)[q].num != 0 ? dup[q] : cand[q] == 0)
+						mask = 0;
+					else
+					if ((*tab)[q].num == 0 && std::has_single_bit(cand[q]))
+						mask = static_cast<uint16_t>(mask & ~cand[q]);
+				}
+				allowed[c.pos] = mask;
+				for (size_t u: units_(c.pos))
+				{
+					more[u] = static_cast<uint16_t>(more[u] | (once[u] & mask));
+					once[u] = static_cast<uint16_t>(once[u] | mask);
+				}
+			}
 
-	class Backup: public std::array<std::tuple<Cell *, uint, bool>, 81>
-	{
-	public:
+			for (Cell &c: *tab)
+			{
+				if (c.num != 0)
+					continue;
+				auto [r, k, s] = units_(c.pos);
+				uint16_t naked  = std::has_single_bit(cand[c.pos]) ? 0x3FE : 0;
+				uint16_t hidden = static_cast<uint16_t>(~(more[r] & more[k] & more[s]));
+				sure_[c.pos] = static_cast<uint16_t>(allowed[c.pos] & (naked | hidden));
+				if (sure_[c.pos] != 0)
+					list_[size_++] = { &c, static_cast<uint>(std::countr_zero(sure_[c.pos])) };
+				else
+				if (std::popcount(cand[c.pos]) < 2)
+					stuck_ = true;
+			}
+		}
 
-		Backup( cell_array *tab )
+		// the same as Cell::sure(n)
+		uint sure( const Cell &c, uint n = 0 ) const
 		{
-			std::ranges::transform(*tab, Backup::begin(), []( Cell &c )
-			{
-				return std::make_tuple(&c, c.num, c.immutable);
-			});
+			if (n == 0)
+				return sure_[c.pos] != 0 ? static_cast<uint>(std::countr_zero(sure_[c.pos])) : 0;
+
+			return (sure_[c.pos] & (1U << n)) != 0 ? n : 0;
 		}
 
-		void reload()
+		// an empty cell without any sure digit and with less than two candidates
+		bool stuck() const
 		{
-			std::ranges::for_each(*this, []( std::tuple<Cell *, uint, bool> &t )
-			{
-				Cell *c = std::get<Cell *>(t);
-				std::get<uint>(t) = c->num;
-				std::get<bool>(t) = c->immutable;
-			});
+			return stuck_;
 		}
 
-		void restore()
+		size_t size() const
 		{
-			std::ranges::for_each(*this, []( std::tuple<Cell *, uint, bool> &t )
-			{
-				Cell *c = std::get<Cell *>(t);
-				c->num = std::get<uint>(t);
-				c->immutable = std::get<bool>(t);
-			});
+			return size_;
 		}
 
-		bool changed()
+		auto begin() const
 		{
-			return std::ranges::any_of(*this, []( std::tuple<Cell *, uint, bool> &t )
-			{
-				Cell *c = std::get<Cell *>(t);
-				return c->num != std::get<uint>(t);
-			});
+			return list_.begin();
 		}
 
-		uint len()
+		auto end() const
 		{
-			auto result = std::ranges::count_if(*this, []( std::tuple<Cell *, uint, bool> &t )
-			{
-				return std::get<uint>(t) != 0;
-			});
-			return static_cast<uint>(result);
+			return list_.begin() + static_cast<std::ptrdiff_t>(size_);
 		}
 	};
 
-	class Temp: public Sudoku::Backup
+private:
+
+	// the solution of the accepted layout, kept until the layout is edited;
+	// after a hit in the cache it is pending and found on the first use
+	enum class Known { None, Pending, Unique };
+
+	std::array<uint8_t, 81> answers;
+	Known                   known;
+	uint                    mistakes;	// entries of the player that differ from the solution, kept by set() and undo()
+
+	// references to all cells of the table, without any heap allocation
+	class Cells: public std::array<cell_ref, 81>
 	{
-	public:
+		template<size_t... I>
+		Cells( cell_array *tab, std::index_sequence<I...> ): std::array<cell_ref, 81>{ (*tab)[I]... } {}
 
-		Temp( cell_array *tab ): Sudoku::Backup(tab) {}
-		~Temp() { Sudoku::Backup::restore(); }
+	public:
 
-		bool reset()
-		{
-			return std::ranges::all_of(*this, []( std::tuple<Cell *, uint, bool> &t )
-			{
-				Cell *c = std::get<Cell *>(t);
-				return c->set(std::get<uint>(t));
-			});
-		}
+		Cells( cell_array *tab ): Cells(tab, std::make_index_sequence<81>{}) {}
 	};
 
-	class Random: public std::vector<cell_ref>
+	class Random: public Sudoku::Cells
 	{
 	public:
 
-		Random( cell_array *tab ): std::vector<cell_ref>(std::begin(*tab), std::end(*tab))
+		Random( cell_array *tab ): Sudoku::Cells(tab)
 		{
 			std::ranges::shuffle(*this, gen);
 		}
@@ -465,11 +1385,11 @@ class Sudoku: public cell_array
 		}
 	};
 
-	class Sorted: public std::vector<cell_ref>
+	class Sorted: public Sudoku::Cells
 	{
 	public:
 
-		Sorted( cell_array *tab, bool(*compare)(Cell &, Cell&) ): std::vector<cell_ref>(std::begin(*tab), std::end(*tab))
+		Sorted( cell_array *tab, bool(*compare)(Cell &, Cell&) ): Sudoku::Cells(tab)
 		{
 			std::ranges::sort(*this, compare);
 		}
@@ -482,8 +1402,16 @@ public:
 	uint32_t   signature;
 	int        duration;
 
-	Sudoku( Difficulty l = Difficulty::Easy ): mem{}, level{l}, rating{0}, signature{0}, duration{0}
+	static inline
+	SudokuCache *cache = nullptr;
+
+	// the cells are linked to their peers and the trail points to the table, so a board is never copied or moved
+	Sudoku( const Sudoku & ) = delete;
+	Sudoku &operator=( const Sudoku & ) = delete;
+
+	Sudoku( Difficulty l = Difficulty::Easy ): mem{}, trail{this}, answers{}, known{Known::None}, mistakes{0}, level{l}, rating{0}, signature{0}, duration{0}
 	{
+		SUDOKU_PHASE(Construct);
 		for (Cell &cell: *this)
 		{
 			auto pos = &cell - this->cell_array::data();
@@ -523,8 +1451,51 @@ public:
 		return std::ranges::none_of(*this, []( Cell &c ){ return c.empty() || c.corrupt(); });
 	}
 
+	// the digit of the unique solution of the layout, 0 if the layout has no unique solution
+	uint answer( const Cell *cell )
+	{
+		return cell != nullptr && Sudoku::unique() ? Sudoku::answers[cell->pos] : 0;
+	}
+
+	// the entry of the player differs from the unique solution of the layout
+	bool mistake( const Cell *cell )
+	{
+		return cell != nullptr && cell->num != 0 && !cell->immutable && Sudoku::unique() && cell->num != Sudoku::answers[cell->pos];
+	}
+
+	// the number of the entries of the player that differ from the unique solution of the layout
+	uint wrong()
+	{
+		return Sudoku::unique() ? Sudoku::mistakes : 0;
+	}
+
+	// the digit for the empty cell; taken from the solution while the board is free of mistakes
+	uint hint( Cell *cell )
+	{
+		if (cell == nullptr || cell->num != 0)
+			return 0;
+
+		if (Sudoku::unique() && Sudoku::mistakes == 0)
+			return Sudoku::answer(cell);
+
+		return cell->sure();
+	}
+
+	// the same as len() == 81 && solved(), but compared with the solution if it is known
+	bool finished()
+	{
+		if (Sudoku::len() < 81)
+			return false;
+
+		if (Sudoku::unique())
+			return Sudoku::mistakes == 0;
+
+		return Sudoku::solved();
+	}
+
 	bool set( Cell *cell, uint n, Force force = Force::Direct )
 	{
+		SUDOKU_PHASE(Set);
 		if (cell == nullptr)
 			return false;
 
@@ -533,6 +1504,8 @@ public:
 		if (t == n)
 			return false;
 
+		bool wrong = Sudoku::mistake(cell);
+
 		switch (force)
 		{
 		case Force::Direct:
@@ -551,6 +1524,7 @@ public:
 			break;
 		}
 
+		Sudoku::mistakes = Sudoku::mistakes - wrong + Sudoku::mistake(cell);
 		Sudoku::mem.emplace_back(cell, t);
 		Sudoku::rating = 0;
 		return true;
@@ -563,6 +1537,7 @@ public:
 
 		if (deep)
 		{
+			Sudoku::known = Known::None;
 			Sudoku::rating = 0;
 			Sudoku::signature = 0;
 			if (Sudoku::level > Difficulty::Easy && Sudoku::level < Difficulty::Extreme)
@@ -574,10 +1549,16 @@ public:
 	{
 		for (Cell &c: *this)
 			c.immutable = false;
+
+		Sudoku::known = Known::None;
 	}
 
 	void accept( bool estimate = false, Difficulty difficulty = Difficulty::Any )
 	{
+		static SudokuLatency latency("accept");
+		auto timer = SudokuLatency::Timer(latency);
+		SUDOKU_PHASE(Accept);
+
 		for (Cell &c: *this)
 			c.immutable = c.num != 0;
 
@@ -588,29 +1569,70 @@ public:
 		Sudoku::mem.clear();
 	}
 
-	void init( std::basic_string<TCHAR> txt )
+	// the clues ('1'..'9') and the entries of the player ('A'..'I') are written unchecked when the whole
+	// layout keeps the rules; otherwise they are set one by one and the breaking ones are left out
+	template<class T>
+	void init( const T *txt, const size_t size )
 	{
+		SUDOKU_PHASE(Init);
+		auto clues = Sudoku::layout_(txt, size, static_cast<T>('0'));
 		Sudoku::clear();
 
-		for (Cell &c: *this)
+		if (Sudoku::conflicts_(clues).none())
 		{
-			if (c.pos < static_cast<uint>(txt.size()))
-			{
-				int x = txt[c.pos] - _T('0');
-				c.set(x >= 0 && x <= 9 ? static_cast<uint>(x) : 0U);
-			}
+			for (Cell &c: *this)
+				c.num = clues[c.pos];
+		}
+		else
+		{
+			for (Cell &c: *this)
+				c.set(clues[c.pos]);
 		}
 
 		Sudoku::accept();
 
+		auto moves = Sudoku::layout_(txt, size, static_cast<T>('@'));
+		auto state = moves;
+		for (Cell &c: *this)
+			if (c.immutable)
+				state[c.pos] = static_cast<uint8_t>(c.num);
+
+		bool checked = Sudoku::conflicts_(state).any();
 		for (Cell &c: *this)
 		{
-			if (c.pos < static_cast<uint>(txt.size()))
-			{
-				int x = txt[c.pos] - _T('@');
-				c.set(x >= 0 && x <= 9 ? static_cast<uint>(x) : 0U);
-			}
+			if (c.immutable)
+				continue;
+			if (checked)
+				c.set(moves[c.pos]);
+			else
+				c.num = moves[c.pos];
 		}
+
+		Sudoku::count_mistakes();	// of the entries placed after accept()
+	}
+
+	void init( const std::basic_string<TCHAR> &txt )
+	{
+		Sudoku::init(txt.data(), txt.size());
+	}
+
+	void init( const SudokuRecord &rec )
+	{
+		Sudoku::init(rec.cells.data(), rec.cells.size());
+	}
+
+	SudokuRecord record()
+	{
+		SudokuRecord rec;
+		for (Cell &c: *this)
+			rec.cells[c.pos] = (c.immutable ? ".123456789" : ".ABCDEFGHI")[c.num];
+
+		rec.level     = Sudoku::level;
+		rec.length    = Sudoku::len();
+		rec.rating    = Sudoku::rating;
+		rec.signature = Sudoku::signature;
+		rec.duration  = Sudoku::duration;
+		return rec;
 	}
 
 	void again()
@@ -619,6 +1641,7 @@ public:
 			if (!c.immutable)
 				c.num = 0;
 
+		Sudoku::mistakes = 0;
 		Sudoku::mem.clear();
 	}
 
@@ -652,6 +1675,10 @@ private:
 		for (Cell &c: *this)
 			c.num = v[c.num];
 
+		// the digits, rows and columns are permuted; the solution is found again on the first use
+		if (Sudoku::known == Known::Unique)
+			Sudoku::known = Known::Pending;
+
 		for (uint i = 0; i < 81; i++)
 		{
 			uint c1 = ::random(9);
@@ -690,18 +1717,57 @@ private:
 		return 0;
 	}
 
-	int correct()
+	void keep( const Analysis &analysis )
+	{
+		Sudoku::answers = analysis.solution;
+		Sudoku::known = analysis.status == 0 ? Known::Unique : Known::None;
+		Sudoku::count_mistakes();
+	}
+
+	void count_mistakes()
+	{
+		auto result = Sudoku::known != Known::Unique ? 0 : std::ranges::count_if(*this, [this]( Cell &c )
+		{
+			return c.num != 0 && !c.immutable && c.num != Sudoku::answers[c.pos];
+		});
+		Sudoku::mistakes = static_cast<uint>(result);
+	}
+
+	// the solution is looked for only when the layout has been accepted
+	bool unique()
+	{
+		if (Sudoku::known == Known::Pending)
+		{
+			{
+				auto tmp = Sudoku::Temp(this);
+				for (Cell &c: *this)
+					if (!c.immutable)
+						c.num = 0;
+				auto analysis = Sudoku::Analysis(this);
+				if (Sudoku::solvable() == 0)
+					Sudoku::correct(&analysis);
+				Sudoku::keep(analysis);
+			}
+			Sudoku::count_mistakes();	// of the entries restored by tmp
+		}
+
+		return Sudoku::known == Known::Unique;
+	}
+
+	int correct( Analysis *analysis = nullptr )
 	{
 		auto tmp = Sudoku::Temp(this);
 
 		std::ranges::max_element(*this, Cell::by_length)->solve();
 		if (!Sudoku::solved())
-			return -2;
+			return analysis != nullptr ? analysis->status = -2 : -2;
 
-		if (!std::ranges::all_of(*this, [this]( Cell &c ){ return c.generate(Sudoku::level, true) != c.immutable; }))
-			return -1;
+		if (analysis != nullptr)
+			for (Cell &c: *this)
+				analysis->solution[c.pos] = static_cast<uint8_t>(c.num);
 
-		return 0;
+		int result = std::ranges::all_of(*this, [this]( Cell &c ){ return c.generate(Sudoku::level, true) != c.immutable; }) ? 0 : -1;
+		return analysis != nullptr ? analysis->status = result : result;
 	}
 
 	bool simplify( bool confirm = false )
@@ -712,12 +1778,12 @@ private:
 		do
 		{
 			simplified = false;
-			for (Cell &c: *this)
+			for (auto &s: Sudoku::Singles(this))
 			{
-				if (c.num == 0 && (c.num = c.sure(0)) != 0)
+				if (s.cell->set(s.num))
 				{
 					if (confirm)
-						c.immutable = true;
+						s.cell->immutable = true;
 					result = simplified = true;
 				}
 			}
@@ -743,6 +1809,17 @@ public:
 
 	void solve()
 	{
+		static SudokuLatency latency("solve");
+		auto timer = SudokuLatency::Timer(latency);
+		SUDOKU_PHASE(Solve);
+
+		if (Sudoku::unique() && Sudoku::mistakes == 0)
+		{
+			for (Cell &c: *this)
+				c.num = Sudoku::answers[c.pos];
+			Sudoku::mem.clear();
+		}
+		else
 		if (Sudoku::solvable() == 0)
 		{
 			std::ranges::max_element(*this, Cell::by_length)->solve();
@@ -752,9 +1829,17 @@ public:
 
 	void generate( Difficulty difficulty = Difficulty::Any )
 	{
+		static SudokuLatency latency[] = { SudokuLatency("generate easy"), SudokuLatency("generate medium"), SudokuLatency("generate hard"),
+		                                   SudokuLatency("generate expert"), SudokuLatency("generate extreme") };
+
+		auto span = SudokuTrace::Span("generate");
+		SUDOKU_PHASE(Generate);
+
 		if (difficulty != Difficulty::Any)
 			Sudoku::level = difficulty;
 
+		auto timer = SudokuLatency::Timer(latency[Sudoku::level]);
+
 		if (Sudoku::level == Difficulty::Extreme)
 		{
 			Sudoku::init(Sudoku::extreme[::random(static_cast<uint>(Sudoku::extreme.size()))]);
@@ -773,6 +1858,7 @@ public:
 
 	bool verify( bool forced )
 	{
+		auto span = SudokuTrace::Span("verify");
 		Difficulty current = Sudoku::level;
 		Sudoku::accept(true);
 		if (Sudoku::rating >= 0 && (!forced || (Sudoku::level >= current && Sudoku::level >= Difficulty::Hard)))
@@ -781,12 +1867,23 @@ public:
 				Sudoku::simplify(true);
 			return true;
 		}
+		switch (Sudoku::rating)
+		{
+		case -2:  SUDOKU_COUNT(RejectUnsolvable); break;
+		case -1:  SUDOKU_COUNT(RejectAmbiguous);  break;
+		default:  SUDOKU_COUNT(RejectLevel);      break;
+		}
 		Sudoku::level = current;
 		return false;
 	}
 
-	void raise( bool force = true, bool show = true )
+	// returns false if the budget has run out or the stop has been requested; the best layout reached so far is kept
+	bool raise( bool force = true, bool show = true, SudokuBudget budget = {} )
 	{
+		static SudokuLatency latency("raise");
+		auto timer = SudokuLatency::Timer(latency);
+		auto span = SudokuTrace::Span("raise");
+		SUDOKU_PHASE(Raise);
 		Sudoku::accept(false, Difficulty::Medium);
 		if (show)
 			std::cerr << *this << std::endl;
@@ -804,34 +1901,50 @@ public:
 
 		bool forced = false;
 		bool success = true;
+		bool stopped = false;
 		while (success && Sudoku::len() > 17)
 		{
 			forced = forced || (force && (Sudoku::level >= Difficulty::Hard || Sudoku::len() <= 30));
 			success = false;
 			auto vec = Sudoku::Sorted(this, Cell::by_solid);
+			auto base = Sudoku::trail.mark();
 			for (auto i = vec.begin(); i != vec.end(); ++i)
 			{
 				Cell &ci = *i;
 				if (ci.num == 0) continue;
-				uint ni = ci.num;
-				ci.num = 0;
+				auto mi = Sudoku::trail.mark();
+				Sudoku::trail.assign(ci, 0);
 
 				for (auto j = i + 1; j != vec.end(); ++j)
 				{
 					Cell &cj = *j;
 					if (cj.num == 0) continue;
-					uint nj = cj.num;
-					cj.num = 0;
+					auto mj = Sudoku::trail.mark();
+					Sudoku::trail.assign(cj, 0);
 
 					for (Cell &cell: Sudoku::Random(this))
 					{
 						if (cell.num != 0) continue;
 						if (&cell != &ci && &cell != &cj && !cell.linked(&ci) && !cell.linked(&cj)) continue;
 
+						auto mc = Sudoku::trail.mark();
 						for (uint v: Cell::Values(cell))
 						{
-							if ((cell.num = v) != 0 && Sudoku::verify(forced))
+							if (v != 0 && !budget.spend())
+							{
+								stopped = true;
+								break;
+							}
+
+							if (v == 0)
+								continue;
+
+							SUDOKU_COUNT(RaiseTried);
+							Sudoku::trail.rollback(mc);
+							Sudoku::trail.assign(cell, v);
+							if (Sudoku::verify(forced))
 							{
+								SUDOKU_COUNT(RaiseAccepted);
 								if (show)
 								{
 									if (Sudoku::len() <= 20)
@@ -845,21 +1958,38 @@ public:
 						}
 
 						if (success) break;
-						cell.num = 0;
+						Sudoku::trail.rollback(mc);
+						if (stopped) break;
 					}
 
 					if (success) break;
-					cj.num = nj;
+					Sudoku::trail.rollback(mj);
+					if (stopped) break;
 				}
 
 				if (success) break;
-				ci.num = ni;
+				Sudoku::trail.rollback(mi);
+				if (stopped) break;
 			}
+
+			Sudoku::trail.keep(base);
 		}
 
 		Sudoku::accept();
 		if (show)
 			std::cerr << *this << std::endl;
+
+		return !stopped;
+	}
+
+	// cells of the record breaking the rules
+	static std::bitset<81> conflicts( const SudokuRecord &rec )
+	{
+		auto clues = Sudoku::layout_(rec.cells.data(), rec.cells.size(), '0');
+		auto moves = Sudoku::layout_(rec.cells.data(), rec.cells.size(), '@');
+		for (size_t i = 0; i < clues.size(); i++)
+			clues[i] = static_cast<uint8_t>(clues[i] | moves[i]);
+		return Sudoku::conflicts_(clues);
 	}
 
 	bool test( bool all )
@@ -883,7 +2013,10 @@ public:
 	{
 		if (!Sudoku::mem.empty())
 		{
-			std::get<Cell *>(Sudoku::mem.back())->num = std::get<uint>(Sudoku::mem.back());
+			Cell *cell = std::get<Cell *>(Sudoku::mem.back());
+			bool wrong = Sudoku::mistake(cell);
+			cell->num = std::get<uint>(Sudoku::mem.back());
+			Sudoku::mistakes = Sudoku::mistakes - wrong + Sudoku::mistake(cell);
 			Sudoku::mem.pop_back();
 			return false;
 		}
@@ -897,33 +2030,68 @@ public:
 
 private:
 
-	int parse_rating()
+	template<class T>
+	static std::array<uint8_t, 81> layout_( const T *txt, const size_t size, const T zero )
 	{
-		std::vector<std::pair<Cell *, uint>> sure;
-		for (Cell &c: *this)
+		std::array<uint8_t, 81> result{};
+		for (size_t i = 0; i < std::min(size, result.size()); i++)
+		{
+			int x = txt[i] - zero;
+			result[i] = static_cast<uint8_t>(x >= 0 && x <= 9 ? x : 0);
+		}
+		return result;
+	}
+
+	// repeated digits in a row, column or segment, and empty cells without any candidate;
+	// checked with the bit masks of the 27 units, without any search
+	static std::bitset<81> conflicts_( const std::array<uint8_t, 81> &num )
+	{
+		auto units = []( const size_t p ){ return std::array<size_t, 3>{ p / 9, 9 + p % 9, 18 + p / 27 * 3 + p % 9 / 3 }; };
+
+		std::array<uint16_t, 27> seen{};
+		std::array<uint16_t, 27> twice{};
+		for (size_t p = 0; p < num.size(); p++)
 		{
-			if (c.num == 0)
+			if (num[p] == 0)
+				continue;
+			auto bit = static_cast<uint16_t>(1U << num[p]);
+			for (size_t u: units(p))
 			{
-				uint n = c.sure();
-				if (n != 0)
-					sure.emplace_back(&c, n);
-				else
-				if (c.len() < 2) // wrong way
-					return 0;
+				twice[u] = static_cast<uint16_t>(twice[u] | (seen[u] & bit));
+				seen[u]  = static_cast<uint16_t>(seen[u] | bit);
 			}
 		}
 
-		if (!sure.empty())
+		std::bitset<81> result;
+		for (size_t p = 0; p < num.size(); p++)
+		{
+			auto [r, c, s] = units(p);
+			if (num[p] != 0)
+				result[p] = ((twice[r] | twice[c] | twice[s]) & (1U << num[p])) != 0;
+			else
+				result[p] = ((seen[r] | seen[c] | seen[s]) & 0x3FE) == 0x3FE;
+		}
+		return result;
+	}
+
+	int parse_rating()
+	{
+		SUDOKU_COUNT(RatingNodes);
+		auto singles = Sudoku::Singles(this);	// on the stack of every level of the recursion
+		if (singles.stuck()) // wrong way
+			return 0;
+
+		if (singles.size() > 0)
 		{
+			auto mark    = Sudoku::trail.mark();
 			int  result  = 0;
 			bool success = true;
-			for (std::pair<Cell *, uint> &p: sure)
-				if (!std::get<Cell *>(p)->set(std::get<uint>(p)))
+			for (auto &p: singles)
+				if (!Sudoku::trail.set(*p.cell, p.num))
 					success = false;
 			if (success)
 				result = Sudoku::parse_rating() + 1;
-			for (std::pair<Cell *, uint> &p: sure)
-				std::get<Cell *>(p)->num = 0;
+			Sudoku::trail.rollback(mark);
 			return result;
 		}
 			
@@ -939,12 +2107,13 @@ private:
 			if (c.num == 0 && c.len() == len && c.range() == range)
 			{
 				int r = 0;
+				auto mark = Sudoku::trail.mark();
 				for (uint v: Cell::Values(c))
 				{
-					if (v != 0 && c.set(v))
+					if (v != 0 && Sudoku::trail.set(c, v))
 					{
 						r += Sudoku::parse_rating();
-						c.num = 0;
+						Sudoku::trail.rollback(mark);
 					}
 				}
 				if (result == 0 || r < result)
@@ -972,10 +2141,12 @@ private:
 		return crc;
 	}
 
-	void calculate_rating( bool estimate = false )
+	void calculate_rating( Analysis &analysis, bool estimate = false )
 	{
-		Sudoku::rating = Sudoku::solvable(); if (Sudoku::rating != 0) return;
-		Sudoku::rating = Sudoku::correct();  if (Sudoku::rating != 0) return;
+		auto span = SudokuTrace::Span("calculate_rating");
+		SUDOKU_PHASE(Rating);
+		Sudoku::rating = Sudoku::solvable();        if (Sudoku::rating != 0) return;
+		Sudoku::rating = Sudoku::correct(&analysis); if (Sudoku::rating != 0) return;
 
 		if (estimate || Sudoku::level == Difficulty::Extreme) return;
 
@@ -987,20 +2158,24 @@ private:
 	//	Sudoku::rating = Sudoku::parse_rating();
 	}
 
-	void calculate_level()
+	void calculate_level( const Analysis &analysis )
 	{
+		auto span = SudokuTrace::Span("calculate_level");
+		SUDOKU_PHASE(Level);
 		if ( Sudoku::level                      == Difficulty::Easy)    { return; }
 		if ( Sudoku::level                      == Difficulty::Extreme) { return; }
 		if ( Sudoku::rating < 0) { Sudoku::level = Difficulty::Medium;    return; }
-		if ( Sudoku::solved())   { Sudoku::level = Difficulty::Medium;    return; }
+		if ( analysis.solved())  { Sudoku::level = Difficulty::Medium;    return; }
 		if (!Sudoku::simplify()) { Sudoku::level = Difficulty::Expert;    return; }
 		if (!Sudoku::solved())   { Sudoku::level = Difficulty::Hard;              }
 		else                     { Sudoku::level = Difficulty::Medium;            }
 		Sudoku::again();
 	}
 
-	void calculate_signature( bool estimate = false )
+	void calculate_signature( Analysis &analysis, bool estimate = false )
 	{
+		auto span = SudokuTrace::Span("calculate_signature");
+		SUDOKU_PHASE(Signature);
 		if (estimate)
 		{
 			Sudoku::signature = 0;
@@ -1014,8 +2189,8 @@ private:
 		for (Cell &c: *this)
 		{
 			v[c.num]++;
-			l[c.pos] = static_cast<uint32_t>(c.len());
-			r[c.pos] = static_cast<uint32_t>(c.range());
+			l[c.pos] = static_cast<uint32_t>(analysis.len(c));
+			r[c.pos] = static_cast<uint32_t>(analysis.range(c));
 		}
 
 		std::ranges::sort(v);
@@ -1027,11 +2202,41 @@ private:
 		Sudoku::signature = Sudoku::calculate_crc32(r, Sudoku::signature);
 	}
 
+	// key of the layout for the cache; the exact layout is hashed, because even the order of the rows
+	// and columns can change the rating of parse_rating
+	uint64_t calculate_key()
+	{
+		// FNV-1a
+		uint64_t key = 0xCBF29CE484222325;
+		auto hash = [&key]( uint x ){ key = (key ^ x) * 0x100000001B3; };
+
+		hash(Sudoku::level == Difficulty::Easy ? 1U : Sudoku::level == Difficulty::Extreme ? 3U : 2U);
+		for (Cell &c: *this)
+			hash(c.num);
+
+		return key != 0 ? key : 1;
+	}
+
 	void specify_layout( bool estimate = false )
 	{
-		Sudoku::calculate_rating(estimate);
-		Sudoku::calculate_level();		// must be after calculate_rating (depends on the rating)
-		Sudoku::calculate_signature(estimate);
+		auto span = SudokuTrace::Span("specify_layout");
+
+		// the layout is the only input of the rating, the level and the signature, so they can be reused
+		uint64_t key = Sudoku::cache != nullptr && !estimate ? Sudoku::calculate_key() : 0;
+		if (key != 0 && Sudoku::cache->find(key, Sudoku::rating, Sudoku::level, Sudoku::signature))
+		{
+			Sudoku::known = Known::Pending;
+			return;
+		}
+
+		auto analysis = Sudoku::Analysis(this);
+		Sudoku::calculate_rating(analysis, estimate);
+		Sudoku::calculate_level(analysis);		// must be after calculate_rating (depends on the rating)
+		Sudoku::calculate_signature(analysis, estimate);
+		Sudoku::keep(analysis);
+
+		if (key != 0)
+			Sudoku::cache->store(key, Sudoku::rating, Sudoku::level, Sudoku::signature);
 	}
 
 public:
@@ -1110,12 +2315,15 @@ public:
 
 	bool load( const TCHAR *filename = nullptr, int * const gametime = nullptr )
 	{
+		static SudokuLatency latency("load");
+		auto timer = SudokuLatency::Timer(latency);
+
 		auto name = filename != nullptr ? filename : _T("sudoku.board");
 		auto file = std::basic_ifstream<TCHAR>(name);
 		if (!file.is_open())
 			return false;
 
-		Sudoku::Backup tmp(this);
+		auto tmp = Sudoku::Snapshot(this);
 
 		file >> *this;
 		file.close();
@@ -1126,6 +2334,9 @@ public:
 
 	void save( const TCHAR *filename = nullptr, const int gametime = 0 )
 	{
+		static SudokuLatency latency("save");
+		auto timer = SudokuLatency::Timer(latency);
+
 		auto name = filename != nullptr ? filename : _T("sudoku.board");
 		auto file = std::basic_ofstream<TCHAR>(name, std::ios::out);
 		if (!file.is_open())
@@ -1152,34 +2363,6 @@ public:
 
 		file.close();
 	}
-
-	void append( const TCHAR *filename )
-	{
-		auto file = std::basic_ofstream<TCHAR>(filename, std::ios::app);
-		if (!file.is_open())
-			return;
-
-		file << *this << std::endl;
-
-		file.close();
-	}
-
-	static
-	void load( std::vector<std::basic_string<TCHAR>> &lst, const TCHAR *filename )
-	{
-		auto file = std::basic_ifstream<TCHAR>(filename);
-		if (!file.is_open())
-			return;
-
-		std::basic_string<TCHAR> line;
-		while (std::getline(file, line))
-		{
-			if (line.size() > 0)
-				lst.push_back(line.substr(0, 81));
-		}
-
-		file.close();
-	}
 };
 
 const